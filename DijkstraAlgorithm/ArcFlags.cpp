@@ -0,0 +1,230 @@
+#include "ArcFlags.h"
+#include "ParallelFor.h"
+#include <queue>
+#include <limits>
+#include <algorithm>
+#include <functional>
+
+// -----------------------------------------------------------
+// Splits the nodes at the median of the wider axis of their
+// bounding box, in proportion to the cells each side receives
+// -----------------------------------------------------------
+void ArcFlags::partition(const PointStore& points, vector<uint32_t>& nodes, uint32_t firstCell, uint32_t count)
+{
+    if (count <= 1 || nodes.size() <= 1) {
+        for (uint32_t v : nodes) cellOf[v] = firstCell;
+        return;
+    }
+
+    double minX = numeric_limits<double>::infinity(), maxX = -minX;
+    double minY = minX, maxY = -minX;
+    for (uint32_t v : nodes) {
+        minX = min(minX, points.getX(v));
+        maxX = max(maxX, points.getX(v));
+        minY = min(minY, points.getY(v));
+        maxY = max(maxY, points.getY(v));
+    }
+    bool alongX = maxX - minX >= maxY - minY;
+    auto coordinate = [&](uint32_t v) { return alongX ? points.getX(v) : points.getY(v); };
+
+    uint32_t lowCells = count / 2;
+    auto middle = nodes.begin() + nodes.size() * lowCells / count;
+    nth_element(nodes.begin(), middle, nodes.end(), [&](uint32_t a, uint32_t b) { return coordinate(a) < coordinate(b); });
+
+    vector<uint32_t> high(middle, nodes.end());
+    nodes.erase(middle, nodes.end());
+    partition(points, nodes, firstCell, lowCells);
+    partition(points, high, firstCell + lowCells, count - lowCells);
+}
+
+template <typename GraphType>
+void ArcFlags::build(const PointStore& points, const GraphType& graph, size_t cellCount, uint64_t graphFingerprint, unsigned threads)
+{
+    typedef typename GraphType::NodeType NodeId;
+    typedef typename GraphType::WeightType Weight;
+
+    size_t n = graph.nodeCount();
+    cells = max<size_t>(cellCount, 1);
+    words = (cells + 63) / 64;
+    fingerprint = graphFingerprint;
+
+    // Cells of the stored points; free slots have no lines and stay in cell 0
+    cellOf.assign(n, 0);
+    vector<uint32_t> nodes;
+    for (uint32_t v = 0; v < n && v < points.capacity(); v++) {
+        if (points.isOccupied(v)) nodes.push_back(v);
+    }
+    partition(points, nodes, 0, static_cast<uint32_t>(cells));
+
+    // Flags per line direction; lines inside a cell are flagged for it,
+    // lines entering a cell make their head a boundary node
+    size_t lineCount = 0;
+    vector<uint8_t> isBoundary(n, 0);
+    for (size_t u = 0; u < n; u++) {
+        graph.forEachArc(static_cast<NodeId>(u), [&](NodeId v, Weight, NodeId lineId) {
+            lineCount = max(lineCount, static_cast<size_t>(lineId) + 1);
+            if (cellOf[v] != cellOf[u]) isBoundary[v] = 1;
+        });
+    }
+    flags.assign(lineCount * 2 * words, 0);
+    auto flag = [&](vector<uint64_t>& bits, size_t u, size_t v, size_t lineId, uint32_t c) {
+        bits[(lineId * 2 + (u > v)) * words + c / 64] |= uint64_t(1) << (c % 64);
+    };
+    for (size_t u = 0; u < n; u++) {
+        graph.forEachArc(static_cast<NodeId>(u), [&](NodeId v, Weight, NodeId lineId) {
+            if (cellOf[v] == cellOf[u]) flag(flags, u, v, lineId, cellOf[u]);
+        });
+    }
+
+    vector<uint32_t> sources;
+    for (uint32_t v = 0; v < n; v++) {
+        if (isBoundary[v]) sources.push_back(v);
+    }
+    boundary = sources.size();
+
+    // One backward search per boundary node b; every reached node flags
+    // the direction it was reached by (its first step on a shortest path
+    // to b). One shortest path per node is enough: a query follows it to
+    // b and from there stays in the cell. Threads fill their own bitsets,
+    // merged afterwards.
+    if (threads == 0) threads = workerCount(sources.size() * graph.arcCount());
+    threads = static_cast<unsigned>(max<size_t>(1, min<size_t>(threads, sources.size())));
+    vector<vector<uint64_t>> local(threads - 1, vector<uint64_t>(flags.size(), 0));
+
+    parallelChunks(sources.size(), threads, [&](unsigned chunk, size_t begin, size_t end) {
+        vector<uint64_t>& bits = chunk == 0 ? flags : local[chunk - 1];
+        vector<double> dist(n, numeric_limits<double>::infinity());
+        vector<uint32_t> next(n, UINT32_MAX), nextLine(n, UINT32_MAX);
+        vector<uint32_t> touched;
+
+        typedef pair<double, uint32_t> Entry;
+        priority_queue<Entry, vector<Entry>, greater<Entry>> pq;
+
+        for (size_t k = begin; k < end; k++) {
+            uint32_t b = sources[k];
+            uint32_t c = cellOf[b];
+
+            for (uint32_t v : touched) dist[v] = numeric_limits<double>::infinity();
+            touched.clear();
+
+            dist[b] = 0.0;
+            next[b] = UINT32_MAX;
+            touched.push_back(b);
+            pq.push({ 0.0, b });
+            while (!pq.empty()) {
+                auto [d, x] = pq.top();
+                pq.pop();
+                if (d > dist[x]) continue;  // Skip outdated values
+                if (next[x] != UINT32_MAX) flag(bits, x, next[x], nextLine[x], c);
+
+                graph.forEachReverseArc(static_cast<NodeId>(x), [&](NodeId u, Weight weight, NodeId lineId) {
+                    double alt = d + static_cast<double>(weight);
+                    if (alt < dist[u]) {
+                        if (dist[u] == numeric_limits<double>::infinity()) touched.push_back(static_cast<uint32_t>(u));
+                        dist[u] = alt;
+                        next[u] = x;
+                        nextLine[u] = static_cast<uint32_t>(lineId);
+                        pq.push({ alt, static_cast<uint32_t>(u) });
+                    }
+                });
+            }
+        }
+    });
+
+    for (const vector<uint64_t>& bits : local) {
+        for (size_t i = 0; i < flags.size(); i++) flags[i] |= bits[i];
+    }
+}
+
+double ArcFlags::flaggedShare() const
+{
+    if (flags.empty()) return 0;
+
+    size_t set = 0;
+    for (uint64_t word : flags) {
+        for (; word; word &= word - 1) set++;
+    }
+    return static_cast<double>(set) / (flags.size() / words * cells);
+}
+
+template <typename GraphType>
+ArcFlagQuery<GraphType>::ArcFlagQuery(const GraphType& graph, const ArcFlags& arcFlags)
+    : graph(graph),
+      arcFlags(arcFlags),
+      dist(graph.nodeCount(), numeric_limits<Weight>::max()),
+      prev(graph.nodeCount(), numeric_limits<NodeId>::max()),
+      prevLine(graph.nodeCount(), numeric_limits<NodeId>::max())
+{
+}
+
+template <typename GraphType>
+PathResult<typename ArcFlagQuery<GraphType>::NodeId, typename ArcFlagQuery<GraphType>::Weight>
+ArcFlagQuery<GraphType>::run(NodeId source, NodeId target)
+{
+    const NodeId none = numeric_limits<NodeId>::max();
+    const Weight unreached = numeric_limits<Weight>::max();
+
+    // Reset only what the previous run touched
+    for (NodeId v : touched) {
+        dist[v] = unreached;
+        prev[v] = none;
+        prevLine[v] = none;
+    }
+    touched.clear();
+    settled = 0;
+
+    uint32_t targetCell = arcFlags.cell(static_cast<uint32_t>(target));
+
+    typedef pair<Weight, NodeId> Entry;
+    priority_queue<Entry, vector<Entry>, greater<Entry>> pq;
+
+    dist[source] = Weight();
+    touched.push_back(source);
+    pq.push({ Weight(), source });
+
+    while (!pq.empty()) {
+        auto [d, u] = pq.top();
+        pq.pop();
+
+        if (d > dist[u]) continue;  // Skip outdated values
+        settled++;
+        if (u == target) break;
+        if (observer) observer->onSettle(u, 0);
+
+        graph.forEachArc(u, [&](NodeId v, Weight weight, NodeId lineId) {
+            if (!arcFlags.isFlagged(static_cast<uint32_t>(lineId), static_cast<uint32_t>(u), static_cast<uint32_t>(v), targetCell)) return;
+            Weight alt = d + weight;
+            bool improved = alt < dist[v];
+
+            if (improved) {
+                if (dist[v] == unreached) touched.push_back(v);
+                dist[v] = alt;
+                prev[v] = u;
+                prevLine[v] = lineId;
+                pq.push({ alt, v });
+            }
+            if (observer) observer->onRelax(u, v, lineId, improved, 0);
+        });
+    }
+
+    PathResult<NodeId, Weight> result;
+    if (dist[target] == unreached) return result;
+
+    // Walk the predecessors back to the source
+    result.found = true;
+    result.distance = dist[target];
+    for (NodeId v = target; v != source; v = prev[v]) {
+        result.nodes.push_back(v);
+        result.lines.push_back(prevLine[v]);
+    }
+    result.nodes.push_back(source);
+    reverse(result.nodes.begin(), result.nodes.end());
+    reverse(result.lines.begin(), result.lines.end());
+    return result;
+}
+
+template void ArcFlags::build(const PointStore&, const Graph<size_t, double>&, size_t, uint64_t, unsigned);
+template void ArcFlags::build(const PointStore&, const ProfileGraph<Graph<size_t, double>>&, size_t, uint64_t, unsigned);
+template class ArcFlagQuery<Graph<size_t, double>>;
+template class ArcFlagQuery<ProfileGraph<Graph<size_t, double>>>;
+template class ArcFlagQuery<VersionGraph>;
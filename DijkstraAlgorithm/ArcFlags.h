@@ -0,0 +1,116 @@
+#pragma once
+
+#ifndef ARCFLAGS_H
+#define ARCFLAGS_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "PointStore.h"
+#include "Graph.h"
+#include "ShortestPathQuery.h"
+
+using namespace std;
+
+// Number of cells the points are split into by default
+#define ARCFLAG_CELLS 32
+
+// ------------------------------------------------------------
+// Arc flags: the points are split into cells by a k-d partition
+// of their coordinates (median splits of the wider axis), and
+// every direction of every line gets one bit per cell, set if the
+// direction starts a shortest path into that cell. A query towards
+// a target in cell c only relaxes directions flagged for c, so it
+// ignores most of the graph behind the source.
+// A bit is set for directions inside the cell and for the tree of
+// one backward search per boundary node (a node of the cell entered
+// by a line from outside): any shortest path enters the target cell
+// for the last time at such a node.
+// The bitset is stored per line id and direction (start -> end is
+// the direction from the lower node id), so it serves every
+// adjacency of the same graph, whatever its arc order.
+// Node ids are those of the graph the flags were built on.
+// ------------------------------------------------------------
+class ArcFlags
+{
+private:
+    vector<uint32_t> cellOf;        // Node id -> cell
+    vector<uint64_t> flags;         // Line id * 2 + direction -> 'words' words of cell bits
+    size_t cells = 0;
+    size_t words = 0;
+    size_t boundary = 0;            // Boundary nodes searched by the last build
+    uint64_t fingerprint = 0;
+
+    // k-d partition of the stored points into 'count' cells starting at 'firstCell'
+    void partition(const PointStore& points, vector<uint32_t>& nodes, uint32_t firstCell, uint32_t count);
+
+public:
+    ArcFlags() {}
+
+    // Partitions the points into 'cellCount' cells and computes the flags of the graph,
+    // using all cores (threads = 0) or the given number of threads
+    template <typename GraphType>
+    void build(const PointStore& points, const GraphType& graph, size_t cellCount, uint64_t graphFingerprint, unsigned threads = 0);
+
+    bool empty() const { return cellOf.empty(); }
+    size_t nodeCount() const { return cellOf.size(); }
+    size_t cellCount() const { return cells; }
+    size_t boundaryCount() const { return boundary; }
+    uint64_t getFingerprint() const { return fingerprint; }
+
+    uint32_t cell(uint32_t v) const { return cellOf[v]; }
+
+    // True if the line 'lineId' from u to v starts a shortest path into 'target' cell
+    bool isFlagged(uint32_t lineId, uint32_t u, uint32_t v, uint32_t target) const {
+        size_t slot = (static_cast<size_t>(lineId) * 2 + (u > v)) * words + target / 64;
+        return slot < flags.size() && (flags[slot] >> (target % 64) & 1);
+    }
+
+    // Share of line directions flagged per cell (0..1)
+    double flaggedShare() const;
+
+    // Bytes used by cells and flags
+    size_t memoryUsage() const { return cellOf.size() * sizeof(uint32_t) + flags.size() * sizeof(uint64_t); }
+};
+
+// ------------------------------------------------------------
+// Point-to-point Dijkstra restricted to the directions flagged
+// for the target's cell (same interface as DijkstraQuery)
+// ------------------------------------------------------------
+template <typename GraphType>
+class ArcFlagQuery
+{
+public:
+    typedef typename GraphType::NodeType NodeId;
+    typedef typename GraphType::WeightType Weight;
+
+private:
+    const GraphType& graph;
+    const ArcFlags& arcFlags;
+    vector<Weight> dist;
+    vector<NodeId> prev;
+    vector<NodeId> prevLine;
+    vector<NodeId> touched;
+    size_t settled = 0;
+    SearchObserver* observer = nullptr;
+
+public:
+    ArcFlagQuery(const GraphType& graph, const ArcFlags& arcFlags);
+
+    // Reports the settled nodes and relaxed arcs of the following runs (null = none)
+    void setObserver(SearchObserver* searchObserver) { observer = searchObserver; }
+
+    // Shortest path from source to target
+    PathResult<NodeId, Weight> run(NodeId source, NodeId target);
+
+    // Number of nodes settled by the last run (search space size)
+    size_t settledCount() const { return settled; }
+};
+
+extern template void ArcFlags::build(const PointStore&, const Graph<size_t, double>&, size_t, uint64_t, unsigned);
+extern template void ArcFlags::build(const PointStore&, const ProfileGraph<Graph<size_t, double>>&, size_t, uint64_t, unsigned);
+extern template class ArcFlagQuery<Graph<size_t, double>>;
+extern template class ArcFlagQuery<ProfileGraph<Graph<size_t, double>>>;
+extern template class ArcFlagQuery<VersionGraph>;
+
+#endif
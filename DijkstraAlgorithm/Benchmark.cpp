@@ -0,0 +1,276 @@
+#include "Benchmark.h"
+#include "Graph.h"
+#include "ShortestPathQuery.h"
+#include "Reordering.h"
+#include "CompressedGraph.h"
+#include "ParallelFor.h"
+#include "ContractionHierarchy.h"
+#include "CustomizableHierarchy.h"
+#include "HubLabels.h"
+#include "ArcFlags.h"
+#include "TransitNodes.h"
+#include <chrono>
+#include <random>
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+
+using namespace std;
+
+// Fixed seed so runs are comparable
+#define BENCHMARK_SEED 12345
+// Weight quantum for the integer-weight layouts
+#define BENCHMARK_RESOLUTION 0.01
+// Relative checksum difference still treated as equal (summation order
+// differs between layouts when several shortest paths tie)
+#define BENCHMARK_CHECKSUM_TOLERANCE 1e-9
+
+// Random (source, target) pairs among the stored points
+static vector<pair<uint32_t, uint32_t>> makeQueries(const PointStore& points, size_t queryCount)
+{
+    vector<uint32_t> ids;
+    for (auto it = points.begin(); it != points.end(); ++it) ids.push_back(it.slot());
+
+    mt19937 rng(BENCHMARK_SEED);
+    uniform_int_distribution<size_t> pick(0, ids.size() - 1);
+
+    vector<pair<uint32_t, uint32_t>> queries(queryCount);
+    for (auto& q : queries) q = { ids[pick(rng)], ids[pick(rng)] };
+    return queries;
+}
+
+// -----------------------------------------------------------
+// Times all queries with a prepared query object on one graph
+// layout (ids mapped through 'order').
+// Returns milliseconds; 'checksum' accumulates the distances found
+// and 'settled' (if given) the nodes settled by all queries
+// -----------------------------------------------------------
+template <typename QueryType>
+static double runQueries(QueryType& query, const NodeOrder* order,
+    const vector<pair<uint32_t, uint32_t>>& queries, double& checksum, size_t* settled = nullptr)
+{
+    typedef typename QueryType::NodeId NodeId;
+    checksum = 0;
+    if (settled) *settled = 0;
+
+    auto begin = chrono::steady_clock::now();
+    for (const auto& [s, t] : queries) {
+        NodeId source = order ? order->toNew[s] : s;
+        NodeId target = order ? order->toNew[t] : t;
+        auto result = query.run(source, target);
+        if (result.found) checksum += static_cast<double>(result.distance);
+        if (settled) *settled += query.settledCount();
+    }
+    auto end = chrono::steady_clock::now();
+    return chrono::duration<double, milli>(end - begin).count();
+}
+
+// Same for query algorithms built from the graph alone (Dijkstra by default)
+template <template <typename> class Query = DijkstraQuery, typename GraphType>
+static double timeQueries(const GraphType& graph, const NodeOrder* order,
+    const vector<pair<uint32_t, uint32_t>>& queries, double& checksum, size_t* settled = nullptr)
+{
+    Query<GraphType> query(graph);
+    return runQueries(query, order, queries, checksum, settled);
+}
+
+// Prints one row of the result table. A row whose checksum differs from
+// 'expected' found other distances than the reference row; a negative
+// 'expected' skips the check (rows with different weights).
+static void printRow(const string& name, double ms, double baselineMs, double checksum, size_t queryCount,
+    double expected = -1)
+{
+    cout << " - " << left << setw(22) << name << right
+        << setw(10) << fixed << setprecision(2) << ms << " ms"
+        << setw(10) << setprecision(2) << (ms * 1000.0 / queryCount) << " us/query"
+        << setw(8) << setprecision(2) << (baselineMs / ms) << "x"
+        << "   (checksum " << setprecision(1) << checksum << ")\n";
+    if (expected >= 0 && fabs(checksum - expected) > BENCHMARK_CHECKSUM_TOLERANCE * max(1.0, expected))
+        cout << "   MISMATCH: checksum " << setprecision(1) << checksum
+            << " differs from baseline " << expected << "\n";
+}
+
+void runQueryBenchmark(const GraphVersion& graph, size_t queryCount)
+{
+    const PointStore& points = graph.getPoints();
+    if (points.empty() || queryCount == 0) {
+        cout << "Benchmark Error: No points to query\n";
+        return;
+    }
+
+    vector<pair<uint32_t, uint32_t>> queries = makeQueries(points, queryCount);
+    double checksum = 0;
+
+    cout << "Running " << queryCount << " random queries on "
+        << points.size() << " points / " << graph.getLines().size() << " lines\n";
+
+    // Baseline: original node order, exact weights
+    Graph<size_t, double> original(points, graph.getLines());
+    double baselineMs = timeQueries(original, nullptr, queries, checksum);
+    printRow("Original order", baselineMs, baselineMs, checksum, queryCount);
+    const double baselineChecksum = checksum;
+
+    // Hilbert curve renumbering (uses the point coordinates)
+    NodeOrder hilbert = hilbertOrder(points);
+    Graph<size_t, double> hilbertGraph = original.permuted(hilbert.toNew);
+    size_t settledDijkstra = 0;
+    double ms = timeQueries(hilbertGraph, &hilbert, queries, checksum, &settledDijkstra);
+    printRow("Hilbert order", ms, baselineMs, checksum, queryCount, baselineChecksum);
+    const double hilbertMs = ms;
+
+    // Bidirectional search on the same layout
+    size_t settledBidirectional = 0;
+    ms = timeQueries<BidirectionalDijkstraQuery>(hilbertGraph, &hilbert, queries, checksum, &settledBidirectional);
+    printRow("Bidirectional", ms, baselineMs, checksum, queryCount, baselineChecksum);
+
+    // A* with the Euclidean potential (coordinates in Hilbert numbering)
+    vector<double> xs(hilbertGraph.nodeCount(), 0.0), ys(hilbertGraph.nodeCount(), 0.0);
+    for (auto it = points.begin(); it != points.end(); ++it) {
+        xs[hilbert.toNew[it.slot()]] = it->getX();
+        ys[hilbert.toNew[it.slot()]] = it->getY();
+    }
+    double scale = euclideanPotentialScale(points, graph.getLines(), graph.getProfiles(), 0);
+    AStarQuery<Graph<size_t, double>> astar(hilbertGraph, EuclideanPotential(xs, ys, scale));
+    size_t settledAStar = 0;
+    ms = runQueries(astar, &hilbert, queries, checksum, &settledAStar);
+    printRow(scale > 0 ? "A* (Euclidean)" : "A* (fallback)", ms, baselineMs, checksum, queryCount, baselineChecksum);
+
+    // ALT: A* with landmark bounds (preprocessing timed separately)
+    auto altBegin = chrono::steady_clock::now();
+    LandmarkTable landmarks;
+    landmarks.build(hilbertGraph, LANDMARK_COUNT, 0);
+    double altBuildMs = chrono::duration<double, milli>(chrono::steady_clock::now() - altBegin).count();
+    AStarQuery<Graph<size_t, double>, LandmarkPotential> alt(hilbertGraph, LandmarkPotential(landmarks));
+    size_t settledAlt = 0;
+    ms = runQueries(alt, &hilbert, queries, checksum, &settledAlt);
+    printRow("ALT (" + to_string(landmarks.count()) + " landmarks)", ms, baselineMs, checksum, queryCount, baselineChecksum);
+
+    // Contraction hierarchy (preprocessing timed separately)
+    auto chBegin = chrono::steady_clock::now();
+    ContractionHierarchy hierarchy;
+    hierarchy.build(hilbertGraph, 0);
+    double chBuildMs = chrono::duration<double, milli>(chrono::steady_clock::now() - chBegin).count();
+    CHQuery chQuery(hierarchy);
+    size_t settledCh = 0;
+    ms = runQueries(chQuery, &hilbert, queries, checksum, &settledCh);
+    printRow("Contraction hierarchy", ms, baselineMs, checksum, queryCount, baselineChecksum);
+
+    // Hub labels in the CH order: distance only, and with the path
+    auto hlBegin = chrono::steady_clock::now();
+    HubLabels labels;
+    labels.build(hilbertGraph, hierarchy, 0);
+    double hlBuildMs = chrono::duration<double, milli>(chrono::steady_clock::now() - hlBegin).count();
+    HubLabelQuery hlDistance(labels, false), hlPath(labels);
+    size_t scannedHl = 0;
+    ms = runQueries(hlDistance, &hilbert, queries, checksum, &scannedHl);
+    printRow("Hub labels (distance)", ms, baselineMs, checksum, queryCount, baselineChecksum);
+    ms = runQueries(hlPath, &hilbert, queries, checksum);
+    printRow("Hub labels (path)", ms, baselineMs, checksum, queryCount, baselineChecksum);
+
+    // Transit node routing on the top of the same hierarchy: distance only, and with the path
+    auto tnrBegin = chrono::steady_clock::now();
+    TransitNodeRouting transit;
+    transit.build(hierarchy, xs, ys);
+    double tnrBuildMs = chrono::duration<double, milli>(chrono::steady_clock::now() - tnrBegin).count();
+    TransitNodeQuery transitQuery(transit, hierarchy, false), transitPath(transit, hierarchy);
+    ms = runQueries(transitQuery, &hilbert, queries, checksum);
+    printRow("TNR (distance)", ms, baselineMs, checksum, queryCount, baselineChecksum);
+    ms = runQueries(transitPath, &hilbert, queries, checksum);
+    printRow("TNR (path)", ms, baselineMs, checksum, queryCount, baselineChecksum);
+
+    // Customizable hierarchy: metric-independent order, then the weights (original ids)
+    auto cchBegin = chrono::steady_clock::now();
+    CustomizableHierarchy customizable;
+    customizable.prepare(points, original);
+    auto cchPrepared = chrono::steady_clock::now();
+    customizable.customize(original, 0);
+    auto cchEnd = chrono::steady_clock::now();
+    double cchOrderMs = chrono::duration<double, milli>(cchPrepared - cchBegin).count();
+    double cchCustomizeMs = chrono::duration<double, milli>(cchEnd - cchPrepared).count();
+    CCHQuery cchQuery(customizable);
+    size_t settledCch = 0;
+    ms = runQueries(cchQuery, nullptr, queries, checksum, &settledCch);
+    printRow("Customizable CH", ms, baselineMs, checksum, queryCount, baselineChecksum);
+
+    // Arc flags on a k-d partition of the coordinates (original ids)
+    auto afBegin = chrono::steady_clock::now();
+    ArcFlags arcFlags;
+    arcFlags.build(points, original, ARCFLAG_CELLS, 0);
+    double afBuildMs = chrono::duration<double, milli>(chrono::steady_clock::now() - afBegin).count();
+    ArcFlagQuery<Graph<size_t, double>> arcFlagQuery(original, arcFlags);
+    size_t settledAf = 0;
+    ms = runQueries(arcFlagQuery, nullptr, queries, checksum, &settledAf);
+    printRow("Arc flags", ms, baselineMs, checksum, queryCount, baselineChecksum);
+
+    // Reverse Cuthill-McKee renumbering (topology only)
+    NodeOrder rcm = reverseCuthillMcKeeOrder(original);
+    Graph<size_t, double> rcmGraph = original.permuted(rcm.toNew);
+    ms = timeQueries(rcmGraph, &rcm, queries, checksum);
+    printRow("RCM order", ms, baselineMs, checksum, queryCount, baselineChecksum);
+
+    // Quantized weights (Hilbert order), checksum in quantized units
+    Graph<uint32_t, uint32_t> quantized = Graph<uint32_t, uint32_t>(points, graph.getLines(), 1.0 / BENCHMARK_RESOLUTION)
+        .permuted(hilbert.toNew);
+    ms = timeQueries(quantized, &hilbert, queries, checksum);
+    printRow("CSR 32-bit quantized", ms, baselineMs, checksum, queryCount);
+
+    // Varint stream built from the Hilbert-renumbered edge records (exact weights)
+    vector<EdgeRecord> hilbertEdges = edgeRecords(graph.getLines());
+    for (EdgeRecord& e : hilbertEdges) {
+        e.start = hilbert.toNew[e.start];
+        e.end = hilbert.toNew[e.end];
+    }
+    CompressedGraph compressed;
+    compressed.build(hilbertGraph.nodeCount(), hilbertEdges);
+    ms = timeQueries(compressed, &hilbert, queries, checksum);
+    printRow("Compressed (varint)", ms, baselineMs, checksum, queryCount, baselineChecksum);
+
+    cout << "Settled per query: Dijkstra " << settledDijkstra / queryCount
+        << ", bidirectional " << settledBidirectional / queryCount
+        << ", A* " << settledAStar / queryCount
+        << ", ALT " << settledAlt / queryCount
+        << ", CH " << settledCh / queryCount
+        << ", CCH " << settledCch / queryCount
+        << ", arc flags " << settledAf / queryCount
+        << ", hub label entries " << scannedHl / queryCount << "\n";
+    cout << "ALT precompute " << setprecision(2) << altBuildMs << " ms, tables "
+        << landmarks.memoryUsage() / 1024 << " KB; CH precompute " << chBuildMs << " ms, "
+        << hierarchy.shortcutCount() << " shortcuts, " << hierarchy.memoryUsage() / 1024 << " KB\n";
+    cout << "CCH order " << cchOrderMs << " ms, customize " << cchCustomizeMs << " ms ("
+        << workerCount(customizable.arcCount()) << " threads, " << customizable.arcCount() << " arcs, "
+        << customizable.levelCount() << " levels, " << customizable.memoryUsage() / 1024 << " KB)\n";
+    cout << "Hub labels " << hlBuildMs << " ms, " << labels.averageLabelSize() << " hubs per label, "
+        << labels.bytes() / 1024 << " KB\n";
+    cout << "Transit nodes " << tnrBuildMs << " ms (" << transit.transitCount() << " transit, "
+        << transit.averageAccessCount() << " access nodes, " << transitQuery.localCount() * 100 / queryCount
+        << "% local queries, " << transit.memoryUsage() / 1024 << " KB)\n";
+    cout << "Arc flags " << afBuildMs << " ms (" << arcFlags.cellCount() << " cells, " << arcFlags.boundaryCount()
+        << " boundary points, " << arcFlags.flaggedShare() * 100 << "% flagged, " << arcFlags.memoryUsage() / 1024 << " KB)\n";
+    cout << "Memory: CSR 64-bit " << original.memoryUsage() / 1024
+        << " KB, CSR 32-bit " << quantized.memoryUsage() / 1024
+        << " KB, compressed " << compressed.memoryUsage() / 1024
+        << " KB (decode cost " << setprecision(2) << (ms / hilbertMs) << "x of CSR 64-bit, same order)\n";
+
+    // CSR construction: serial line scan vs parallel edge-list builder
+    auto buildBegin = chrono::steady_clock::now();
+    Graph<size_t, double> serialBuilt(points, graph.getLines());
+    auto buildMid = chrono::steady_clock::now();
+    Graph<size_t, double> parallelBuilt(points.capacity(), edgeRecords(graph.getLines()));
+    auto buildEnd = chrono::steady_clock::now();
+    cout << "Build: serial " << setprecision(2) << chrono::duration<double, milli>(buildMid - buildBegin).count()
+        << " ms, parallel " << chrono::duration<double, milli>(buildEnd - buildMid).count()
+        << " ms (" << workerCount(graph.getLines().size()) << " threads, " << parallelBuilt.arcCount() << " arcs)\n";
+
+    // Every weight profile on one shared topology (original order)
+    const WeightProfiles& profiles = graph.getProfiles();
+    if (profiles.count() > 1) {
+        Graph<size_t, double> profiled(points, graph.getLines(), 1.0, &profiles);
+        for (size_t p = 0; p < profiles.count(); p++) {
+            ms = timeQueries(ProfileGraph<Graph<size_t, double>>(profiled, p), nullptr, queries, checksum);
+            printRow("Profile " + profiles.getName(p), ms, baselineMs, checksum, queryCount,
+                p == 0 ? baselineChecksum : -1);
+        }
+        cout << "Memory: " << profiles.count() << " profiles " << profiled.memoryUsage() / 1024
+            << " KB shared topology vs " << profiles.count() * original.memoryUsage() / 1024 << " KB separate graphs\n";
+    }
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <cstddef>
+#include "GraphVersion.h"
+
+// Runs random point-to-point queries on the current graph and prints timings
+void runQueryBenchmark(const GraphVersion& graph, size_t queryCount);
+
+#endif
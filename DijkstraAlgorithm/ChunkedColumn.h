@@ -0,0 +1,115 @@
+#pragma once
+
+#ifndef CHUNKEDCOLUMN_H
+#define CHUNKEDCOLUMN_H
+
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <cstddef>
+
+using namespace std;
+
+// Entries per chunk of a ChunkedColumn (as a power of two)
+#define COLUMN_CHUNK_BITS 10
+#define COLUMN_CHUNK_SIZE (size_t(1) << COLUMN_CHUNK_BITS)
+
+// ------------------------------------------------------------
+// Makes a shared chunk private before it is written: copies it
+// if another owner (e.g. a published graph version) still holds it
+// ------------------------------------------------------------
+template <typename Chunk>
+void unshareChunk(shared_ptr<Chunk>& chunk)
+{
+    if (chunk.use_count() > 1) {
+        chunk = make_shared<Chunk>(*chunk);
+    }
+    else {
+        // Pairs with the release of the last other owner, whose reads come first
+        atomic_thread_fence(memory_order_acquire);
+    }
+}
+
+// Same for vectors, keeping the capacity (appending stays in place)
+template <typename T>
+void unshareChunk(shared_ptr<vector<T>>& chunk)
+{
+    if (chunk.use_count() > 1) {
+        auto copy = make_shared<vector<T>>();
+        copy->reserve(chunk->capacity());
+        copy->assign(chunk->begin(), chunk->end());
+        chunk = move(copy);
+    }
+    else {
+        // Pairs with the release of the last other owner, whose reads come first
+        atomic_thread_fence(memory_order_acquire);
+    }
+}
+
+// ------------------------------------------------------------
+// Copy-on-write column of values split into fixed-size chunks,
+// each held by its own shared_ptr. Copying a column copies only
+// the chunk pointers, so graph versions share all chunks; writing
+// an entry copies just its chunk if another column still holds it.
+// Reads go through the const operator[], writes through the
+// non-const one (which unshares the chunk).
+// Only the writer thread writes; other threads read the columns of
+// published versions, whose shared chunks are never written again.
+// ------------------------------------------------------------
+template <typename T>
+class ChunkedColumn
+{
+private:
+    vector<shared_ptr<vector<T>>> chunks;
+    size_t count = 0;
+
+    // Chunk c for writing, copied first if it is shared
+    vector<T>& writableChunk(size_t c) {
+        unshareChunk(chunks[c]);
+        return *chunks[c];
+    }
+
+public:
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    const T& operator[](size_t i) const { return (*chunks[i >> COLUMN_CHUNK_BITS])[i & (COLUMN_CHUNK_SIZE - 1)]; }
+    T& operator[](size_t i) { return writableChunk(i >> COLUMN_CHUNK_BITS)[i & (COLUMN_CHUNK_SIZE - 1)]; }
+    const T& back() const { return (*this)[count - 1]; }
+
+    void push_back(const T& value) {
+        if ((count & (COLUMN_CHUNK_SIZE - 1)) == 0) {
+            chunks.push_back(make_shared<vector<T>>());
+            chunks.back()->reserve(COLUMN_CHUNK_SIZE);
+        }
+        writableChunk(chunks.size() - 1).push_back(value);
+        count++;
+    }
+
+    void pop_back() {
+        count--;
+        if ((count & (COLUMN_CHUNK_SIZE - 1)) == 0) chunks.pop_back();
+        else writableChunk(chunks.size() - 1).pop_back();
+    }
+
+    // Grows to n entries, new ones set to 'value' (never shrinks)
+    void resize(size_t n, const T& value) {
+        while (count < n) push_back(value);
+    }
+
+    // Replaces the contents by n copies of 'value'
+    void assign(size_t n, const T& value) {
+        clear();
+        resize(n, value);
+    }
+
+    void clear() {
+        chunks.clear();
+        count = 0;
+    }
+
+    // Pre-allocates the chunk table for n entries
+    void reserve(size_t n) { chunks.reserve((n + COLUMN_CHUNK_SIZE - 1) >> COLUMN_CHUNK_BITS); }
+};
+
+#endif
@@ -0,0 +1,65 @@
+#include "CompressedGraph.h"
+#include <algorithm>
+
+// Appends one LEB128 varint
+static void writeVarint(vector<uint8_t>& out, uint32_t value)
+{
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+// Signed difference as a varint-friendly value (small magnitudes stay short)
+static uint32_t zigzag(uint32_t from, uint32_t to)
+{
+    int32_t delta = static_cast<int32_t>(to - from);
+    return (static_cast<uint32_t>(delta) << 1) ^ static_cast<uint32_t>(delta >> 31);
+}
+
+void CompressedGraph::build(size_t nodes, const vector<EdgeRecord>& edges, uint64_t weightFingerprint)
+{
+    fingerprint = weightFingerprint;
+    offsets.assign(nodes + 1, 0);
+    bytes.clear();
+    lineWeights.clear();
+
+    // Arc slots grouped by tail: degree count, then prefix sums
+    vector<size_t> begin(nodes + 1, 0);
+    for (const EdgeRecord& e : edges) {
+        begin[e.start + 1]++;
+        if (!e.directed) begin[e.end + 1]++;
+        if (e.lineId >= lineWeights.size()) lineWeights.resize(static_cast<size_t>(e.lineId) + 1, 0.0);
+        lineWeights[e.lineId] = e.weight;
+    }
+    for (size_t u = 0; u < nodes; u++) begin[u + 1] += begin[u];
+    arcs = begin[nodes];
+
+    vector<pair<uint32_t, uint32_t>> list(arcs); // (target, line id)
+    vector<size_t> cursor(begin.begin(), begin.end() - 1);
+    for (const EdgeRecord& e : edges) {
+        list[cursor[e.start]++] = { e.end, e.lineId };
+        if (!e.directed) list[cursor[e.end]++] = { e.start, e.lineId };
+    }
+
+    for (size_t u = 0; u < nodes; u++) {
+        offsets[u] = bytes.size();
+
+        auto first = list.begin() + begin[u], last = list.begin() + begin[u + 1];
+        sort(first, last);
+
+        // First target relative to u (zigzag, so small negative deltas stay
+        // short), then gaps; line ids as zigzag deltas to the previous one
+        writeVarint(bytes, static_cast<uint32_t>(last - first));
+        uint32_t target = static_cast<uint32_t>(u), lineId = 0;
+        for (auto it = first; it != last; ++it) {
+            writeVarint(bytes, it == first ? zigzag(target, it->first) : it->first - target);
+            writeVarint(bytes, zigzag(lineId, it->second));
+            target = it->first;
+            lineId = it->second;
+        }
+    }
+    offsets[nodes] = bytes.size();
+    bytes.shrink_to_fit();
+}
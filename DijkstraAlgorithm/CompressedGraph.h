@@ -0,0 +1,82 @@
+#pragma once
+
+#ifndef COMPRESSEDGRAPH_H
+#define COMPRESSEDGRAPH_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "Graph.h"
+
+using namespace std;
+
+// ------------------------------------------------------------
+// Compressed forward adjacency for graphs that do not fit as a
+// plain CSR. Each node's arcs are sorted by target and packed into
+// one byte stream as LEB128 varints:
+//   degree, zigzag(first target - u), target gaps..., with every
+//   target followed by zigzag(line id - previous line id).
+// Neighbours are usually numbered close to each other (see
+// Reordering), and so are the lines between them, so most arcs take
+// 2-3 bytes. Weights are exact and kept once per line, not per arc,
+// looked up through the decoded line id.
+// Built straight from edge records (no CSR in between). Forward
+// arcs only, so it serves one-sided searches (DijkstraQuery).
+// ------------------------------------------------------------
+class CompressedGraph
+{
+private:
+    vector<uint64_t> offsets;   // Byte offset of each node's arc list, size = nodes + 1
+    vector<uint8_t> bytes;      // Encoded arc lists
+    vector<double> lineWeights; // Weight of every line id
+    size_t arcs = 0;
+    uint64_t fingerprint = 0;   // Weight fingerprint the graph was built for
+
+    // Reads one LEB128 varint and advances p
+    static uint32_t readVarint(const uint8_t*& p) {
+        uint32_t value = *p & 0x7F;
+        if (!(*p++ & 0x80)) return value;
+        for (int shift = 7; ; shift += 7) {
+            value |= static_cast<uint32_t>(*p & 0x7F) << shift;
+            if (!(*p++ & 0x80)) return value;
+        }
+    }
+
+    static uint32_t unzigzag(uint32_t value) { return (value >> 1) ^ (0u - (value & 1)); }
+
+public:
+    typedef uint32_t NodeType;
+    typedef double WeightType;
+
+    CompressedGraph() : offsets(1, 0) {}
+
+    // Encodes the arcs of the edges (both directions unless directed) over
+    // 'nodes' node ids, replacing the previous contents
+    void build(size_t nodes, const vector<EdgeRecord>& edges, uint64_t fingerprint = 0);
+
+    bool empty() const { return arcs == 0; }
+    size_t nodeCount() const { return offsets.size() - 1; }
+    size_t arcCount() const { return arcs; }
+    uint64_t getFingerprint() const { return fingerprint; }
+
+    // Bytes used by the offsets, the encoded stream and the line weights
+    size_t memoryUsage() const {
+        return offsets.size() * sizeof(uint64_t) + bytes.size() + lineWeights.size() * sizeof(double);
+    }
+
+    // Decodes the arcs of node u and calls f(target, weight, lineId)
+    template <typename F>
+    void forEachArc(uint32_t u, F&& f) const {
+        const uint8_t* p = bytes.data() + offsets[u];
+        uint32_t degree = readVarint(p);
+        uint32_t target = u, lineId = 0;
+
+        for (uint32_t i = 0; i < degree; i++) {
+            target += i == 0 ? unzigzag(readVarint(p)) : readVarint(p);
+            lineId += unzigzag(readVarint(p));
+            f(target, lineWeights[lineId], lineId);
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,404 @@
+#include "ContractionHierarchy.h"
+#include "ParallelFor.h"
+#include <queue>
+#include <limits>
+#include <numeric>
+#include <algorithm>
+
+// -----------------------------------------------------------
+// Remaining graph during contraction: arcs out of and into every
+// node, at most one per ordered node pair (the lightest)
+// -----------------------------------------------------------
+struct OverlayGraph {
+    vector<vector<ContractionHierarchy::Arc>> out;
+    vector<vector<ContractionHierarchy::Arc>> in;
+
+    explicit OverlayGraph(size_t nodes) : out(nodes), in(nodes) {}
+
+    // Adds u -> v unless a lighter arc already connects them
+    void addArc(uint32_t u, uint32_t v, double weight, uint32_t middle, uint32_t lineId) {
+        for (auto& arc : out[u]) {
+            if (arc.node != v) continue;
+            if (arc.weight <= weight) return;
+            arc = { v, weight, middle, lineId };
+            for (auto& back : in[v]) {
+                if (back.node == u) {
+                    back = { u, weight, middle, lineId };
+                    break;
+                }
+            }
+            return;
+        }
+        out[u].push_back({ v, weight, middle, lineId });
+        in[v].push_back({ u, weight, middle, lineId });
+    }
+
+    // Removes the arc to 'node' from a list
+    static void removeArc(vector<ContractionHierarchy::Arc>& arcs, uint32_t node) {
+        for (size_t i = 0; i < arcs.size(); i++) {
+            if (arcs[i].node == node) {
+                arcs[i] = arcs.back();
+                arcs.pop_back();
+                return;
+            }
+        }
+    }
+};
+
+struct Shortcut {
+    uint32_t from;
+    uint32_t to;
+    double weight;
+};
+
+// -----------------------------------------------------------
+// Witness searches of one thread: bounded Dijkstra runs that
+// reuse their distance array (only touched entries are reset)
+// -----------------------------------------------------------
+class WitnessSearch
+{
+private:
+    vector<double> dist;
+    vector<uint32_t> touched;
+    vector<uint8_t> target;
+    vector<pair<double, uint32_t>> heap;   // Reused priority queue storage
+
+    // Distances from source in the overlay without 'skipped' and the blocked nodes,
+    // up to 'limit' or until the 'targets' marked nodes are settled
+    void run(const OverlayGraph& graph, uint32_t source, uint32_t skipped, const vector<uint8_t>& blocked,
+        double limit, size_t targets, size_t settleLimit) {
+        auto later = greater<pair<double, uint32_t>>();
+        heap.clear();
+        dist[source] = 0.0;
+        touched.push_back(source);
+        heap.push_back({ 0.0, source });
+
+        size_t settled = 0;
+        while (!heap.empty() && settled < settleLimit) {
+            pop_heap(heap.begin(), heap.end(), later);
+            auto [d, u] = heap.back();
+            heap.pop_back();
+            if (d > dist[u]) continue;  // Skip outdated values
+            if (d > limit) break;
+            settled++;
+            if (target[u] && --targets == 0) break;
+
+            for (const auto& arc : graph.out[u]) {
+                if (arc.node == skipped || blocked[arc.node]) continue;
+                double alt = d + arc.weight;
+                if (alt < dist[arc.node]) {
+                    if (dist[arc.node] == numeric_limits<double>::infinity()) touched.push_back(arc.node);
+                    dist[arc.node] = alt;
+                    heap.push_back({ alt, arc.node });
+                    push_heap(heap.begin(), heap.end(), later);
+                }
+            }
+        }
+    }
+
+    void reset() {
+        for (uint32_t v : touched) dist[v] = numeric_limits<double>::infinity();
+        touched.clear();
+    }
+
+public:
+    explicit WitnessSearch(size_t nodes) : dist(nodes, numeric_limits<double>::infinity()), target(nodes, 0) {}
+
+    // Shortcuts needed to contract v: u -> v -> w without a witness path u -> w of the same length.
+    // Witnesses may not pass blocked nodes (the others contracted in the same round).
+    void shortcutsOf(const OverlayGraph& graph, uint32_t v, const vector<uint8_t>& blocked, size_t settleLimit,
+        vector<Shortcut>& result) {
+        result.clear();
+        for (const auto& in : graph.in[v]) {
+            double longest = -1.0;
+            size_t targets = 0;
+            for (const auto& out : graph.out[v]) {
+                if (out.node == in.node) continue;
+                longest = max(longest, out.weight);
+                target[out.node] = 1;
+                targets++;
+            }
+            if (targets == 0) continue;
+
+            run(graph, in.node, v, blocked, in.weight + longest, targets, settleLimit);
+            for (const auto& out : graph.out[v]) {
+                if (out.node == in.node) continue;
+                target[out.node] = 0;
+                if (dist[out.node] > in.weight + out.weight) {
+                    result.push_back({ in.node, out.node, in.weight + out.weight });
+                }
+            }
+            reset();
+        }
+    }
+};
+
+// Scrambles node ids for tie breaking, so equal priorities do not contract in id order
+static uint32_t mixId(uint32_t x)
+{
+    x ^= x >> 16;
+    x *= 0x7feb352dU;
+    x ^= x >> 15;
+    x *= 0x846ca68bU;
+    x ^= x >> 16;
+    return x;
+}
+
+template <typename GraphType>
+void ContractionHierarchy::build(const GraphType& graph, uint64_t graphFingerprint, unsigned threads)
+{
+    size_t n = graph.nodeCount();
+    if (threads == 0) threads = workerCount(graph.arcCount());
+    fingerprint = graphFingerprint;
+
+    OverlayGraph overlay(n);
+    for (size_t u = 0; u < n; u++) {
+        graph.forEachArc(static_cast<typename GraphType::NodeType>(u), [&](auto v, auto weight, auto lineId) {
+            if (v != u) overlay.addArc(static_cast<uint32_t>(u), static_cast<uint32_t>(v), static_cast<double>(weight), CH_NO_MIDDLE, static_cast<uint32_t>(lineId));
+        });
+    }
+
+    // Importance: twice the edge difference plus contracted neighbours.
+    // Estimated with shorter witness searches (more shortcuts at worst).
+    vector<WitnessSearch> scratch(threads, WitnessSearch(n));
+    vector<int> priority(n, 0);
+    vector<int> contractedNeighbours(n, 0);
+    vector<uint8_t> contracting(n, 0);
+    auto updatePriorities = [&](const vector<uint32_t>& nodes) {
+        parallelChunks(nodes.size(), threads, [&](unsigned chunk, size_t begin, size_t end) {
+            vector<Shortcut> found;
+            for (size_t i = begin; i < end; i++) {
+                uint32_t v = nodes[i];
+                scratch[chunk].shortcutsOf(overlay, v, contracting, CH_PRIORITY_SETTLE_LIMIT, found);
+                priority[v] = 2 * (static_cast<int>(found.size()) - static_cast<int>(overlay.in[v].size() + overlay.out[v].size()))
+                    + contractedNeighbours[v];
+            }
+        });
+    };
+    auto lessImportant = [&](uint32_t a, uint32_t b) {
+        if (priority[a] != priority[b]) return priority[a] < priority[b];
+        if (mixId(a) != mixId(b)) return mixId(a) < mixId(b);
+        return a < b;
+    };
+
+    vector<uint32_t> remaining(n);
+    iota(remaining.begin(), remaining.end(), 0);
+    updatePriorities(remaining);
+
+    vector<vector<Arc>> up(n), down(n);
+    rank.assign(n, 0);
+    uint32_t nextRank = 0;
+
+    while (!remaining.empty()) {
+        // Independent set: nodes less important than everything within two hops,
+        // which keeps the nodes of a round apart (and their witnesses intact)
+        vector<uint8_t> selected(remaining.size(), 0);
+        parallelChunks(remaining.size(), threads, [&](unsigned, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                uint32_t v = remaining[i];
+                bool minimum = true;
+                auto check = [&](uint32_t u) {
+                    minimum = minimum && (u == v || lessImportant(v, u));
+                };
+                for (const auto* arcs : { &overlay.out[v], &overlay.in[v] }) {
+                    for (const auto& arc : *arcs) {
+                        check(arc.node);
+                        for (const auto& next : overlay.out[arc.node]) check(next.node);
+                        for (const auto& next : overlay.in[arc.node]) check(next.node);
+                        if (!minimum) break;
+                    }
+                }
+                selected[i] = minimum;
+            }
+        });
+
+        vector<uint32_t> batch, rest;
+        for (size_t i = 0; i < remaining.size(); i++) {
+            (selected[i] ? batch : rest).push_back(remaining[i]);
+        }
+
+        // Witness searches of the batch in parallel (read-only on the overlay);
+        // a witness through another node of the batch would vanish with it
+        for (uint32_t v : batch) contracting[v] = 1;
+        vector<vector<Shortcut>> found(batch.size());
+        parallelChunks(batch.size(), threads, [&](unsigned chunk, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) scratch[chunk].shortcutsOf(overlay, batch[i], contracting, CH_WITNESS_SETTLE_LIMIT, found[i]);
+        });
+        for (uint32_t v : batch) contracting[v] = 0;
+
+        // Contract: keep the node's arcs as hierarchy arcs, then replace it by its shortcuts
+        vector<uint32_t> touched;
+        for (size_t i = 0; i < batch.size(); i++) {
+            uint32_t v = batch[i];
+            rank[v] = nextRank++;
+            up[v] = move(overlay.out[v]);
+            down[v] = move(overlay.in[v]);
+            overlay.out[v].clear();
+            overlay.in[v].clear();
+
+            for (const auto& arc : up[v]) {
+                OverlayGraph::removeArc(overlay.in[arc.node], v);
+                contractedNeighbours[arc.node]++;
+                touched.push_back(arc.node);
+            }
+            for (const auto& arc : down[v]) {
+                OverlayGraph::removeArc(overlay.out[arc.node], v);
+                contractedNeighbours[arc.node]++;
+                touched.push_back(arc.node);
+            }
+            for (const Shortcut& s : found[i]) overlay.addArc(s.from, s.to, s.weight, v, CH_NO_MIDDLE);
+        }
+
+        // Neighbour update: only the neighbours of contracted nodes change importance
+        sort(touched.begin(), touched.end());
+        touched.erase(unique(touched.begin(), touched.end()), touched.end());
+        updatePriorities(touched);
+
+        remaining.swap(rest);
+    }
+
+    // Lay out the hierarchy arcs per node
+    auto flatten = [n](vector<vector<Arc>>& lists, vector<uint32_t>& offsets, vector<Arc>& arcs) {
+        offsets.assign(n + 1, 0);
+        for (size_t u = 0; u < n; u++) offsets[u + 1] = offsets[u] + static_cast<uint32_t>(lists[u].size());
+        arcs.clear();
+        arcs.reserve(offsets[n]);
+        for (auto& list : lists) {
+            arcs.insert(arcs.end(), list.begin(), list.end());
+            vector<Arc>().swap(list);
+        }
+    };
+    flatten(up, upOffsets, upArcs);
+    flatten(down, downOffsets, downArcs);
+
+    shortcuts = 0;
+    for (const Arc& arc : upArcs) shortcuts += arc.middle != CH_NO_MIDDLE;
+    for (const Arc& arc : downArcs) shortcuts += arc.middle != CH_NO_MIDDLE;
+}
+
+void ContractionHierarchy::unpack(uint32_t from, uint32_t to, uint32_t middle, uint32_t lineId,
+    vector<uint32_t>& nodes, vector<uint32_t>& lines) const
+{
+    if (middle == CH_NO_MIDDLE) {
+        nodes.push_back(to);
+        lines.push_back(lineId);
+        return;
+    }
+
+    // Both halves were arcs of the middle node when it was contracted:
+    // from -> middle is one of its downward arcs, middle -> to an upward one
+    for (uint32_t i = downOffsets[middle]; i < downOffsets[middle + 1]; i++) {
+        if (downArcs[i].node == from) {
+            unpack(from, middle, downArcs[i].middle, downArcs[i].lineId, nodes, lines);
+            break;
+        }
+    }
+    for (uint32_t i = upOffsets[middle]; i < upOffsets[middle + 1]; i++) {
+        if (upArcs[i].node == to) {
+            unpack(middle, to, upArcs[i].middle, upArcs[i].lineId, nodes, lines);
+            break;
+        }
+    }
+}
+
+CHQuery::CHQuery(const ContractionHierarchy& hierarchy)
+    : hierarchy(hierarchy)
+{
+    for (int side = 0; side < 2; side++) {
+        dist[side].assign(hierarchy.nodeCount(), numeric_limits<double>::infinity());
+        parent[side].assign(hierarchy.nodeCount(), UINT32_MAX);
+    }
+}
+
+PathResult<uint32_t, double> CHQuery::run(uint32_t source, uint32_t target)
+{
+    const double unreached = numeric_limits<double>::infinity();
+
+    // Reset only what the previous run touched
+    for (int side = 0; side < 2; side++) {
+        for (uint32_t v : touched[side]) {
+            dist[side][v] = unreached;
+            parent[side][v] = UINT32_MAX;
+        }
+        touched[side].clear();
+    }
+    settled = 0;
+
+    typedef pair<double, uint32_t> Entry;
+    priority_queue<Entry, vector<Entry>, greater<Entry>> pq[2];
+
+    dist[0][source] = 0.0;
+    dist[1][target] = 0.0;
+    touched[0].push_back(source);
+    touched[1].push_back(target);
+    pq[0].push({ 0.0, source });
+    pq[1].push({ 0.0, target });
+
+    double best = source == target ? 0.0 : unreached;
+    uint32_t meeting = source == target ? source : UINT32_MAX;
+
+    // Upward searches cannot use the sum criterion: each side runs
+    // until its queue head alone reaches the best distance
+    while (true) {
+        double head0 = pq[0].empty() ? unreached : pq[0].top().first;
+        double head1 = pq[1].empty() ? unreached : pq[1].top().first;
+        if (min(head0, head1) >= best) break;
+
+        int side = head0 <= head1 ? 0 : 1;
+        auto [d, u] = pq[side].top();
+        pq[side].pop();
+        if (d > dist[side][u]) continue;  // Skip outdated values
+        settled++;
+
+        const vector<uint32_t>& offsets = side == 0 ? hierarchy.upOffsets : hierarchy.downOffsets;
+        const vector<ContractionHierarchy::Arc>& arcs = side == 0 ? hierarchy.upArcs : hierarchy.downArcs;
+        for (uint32_t i = offsets[u]; i < offsets[u + 1]; i++) {
+            uint32_t v = arcs[i].node;
+            double alt = d + arcs[i].weight;
+            if (alt < dist[side][v]) {
+                if (dist[side][v] == unreached) touched[side].push_back(v);
+                dist[side][v] = alt;
+                parent[side][v] = i;
+                pq[side].push({ alt, v });
+            }
+            if (dist[1 - side][v] != unreached && dist[side][v] + dist[1 - side][v] < best) {
+                best = dist[side][v] + dist[1 - side][v];
+                meeting = v;
+            }
+        }
+    }
+
+    PathResult<uint32_t, double> result;
+    if (meeting == UINT32_MAX) return result;
+    result.found = true;
+    result.distance = best;
+
+    // Hierarchy arcs source -> meeting: walk back via the tails of the upward arcs
+    vector<pair<uint32_t, uint32_t>> forwardArcs;   // (tail, arc index)
+    for (uint32_t v = meeting; v != source;) {
+        uint32_t arc = parent[0][v];
+        uint32_t tail = static_cast<uint32_t>(upper_bound(hierarchy.upOffsets.begin(), hierarchy.upOffsets.end(), arc)
+            - hierarchy.upOffsets.begin() - 1);
+        forwardArcs.push_back({ tail, arc });
+        v = tail;
+    }
+
+    result.nodes.push_back(source);
+    for (auto it = forwardArcs.rbegin(); it != forwardArcs.rend(); ++it) {
+        const ContractionHierarchy::Arc& arc = hierarchy.upArcs[it->second];
+        hierarchy.unpack(it->first, arc.node, arc.middle, arc.lineId, result.nodes, result.lines);
+    }
+
+    // Hierarchy arcs meeting -> target: the backward search stored them at their heads
+    for (uint32_t v = meeting; v != target;) {
+        uint32_t arc = parent[1][v];
+        uint32_t head = static_cast<uint32_t>(upper_bound(hierarchy.downOffsets.begin(), hierarchy.downOffsets.end(), arc)
+            - hierarchy.downOffsets.begin() - 1);
+        hierarchy.unpack(v, head, hierarchy.downArcs[arc].middle, hierarchy.downArcs[arc].lineId, result.nodes, result.lines);
+        v = head;
+    }
+    return result;
+}
+
+template void ContractionHierarchy::build(const Graph<size_t, double>&, uint64_t, unsigned);
+template void ContractionHierarchy::build(const ProfileGraph<Graph<size_t, double>>&, uint64_t, unsigned);
@@ -0,0 +1,126 @@
+#pragma once
+
+#ifndef CONTRACTIONHIERARCHY_H
+#define CONTRACTIONHIERARCHY_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "Graph.h"
+#include "ShortestPathQuery.h"
+
+using namespace std;
+
+// Nodes a witness search may settle before it gives up (and adds the shortcut)
+#define CH_WITNESS_SETTLE_LIMIT 500
+
+// Same for the searches that only estimate a node's importance
+#define CH_PRIORITY_SETTLE_LIMIT 20
+
+// Marks an arc that is an original line, not a shortcut
+#define CH_NO_MIDDLE UINT32_MAX
+
+// ------------------------------------------------------------
+// Contraction Hierarchy (CH) of a static graph.
+// Preprocessing removes ("contracts") the nodes one by one in order
+// of importance; whenever a shortest path ran through the removed
+// node, a shortcut arc between its neighbours keeps the distance.
+// A witness search (bounded Dijkstra avoiding the node) proves a
+// shortcut unnecessary.
+//  - Importance is the edge difference (shortcuts added minus arcs
+//    removed) plus the number of already contracted neighbours;
+//    after each round only the neighbours of contracted nodes are
+//    recomputed (neighbour updates), the other priorities are kept.
+//  - Each round contracts an independent set (nodes whose importance
+//    is minimal within two hops) in parallel; their witness searches
+//    only read the remaining graph and avoid the other nodes of the
+//    round, the shortcuts are applied afterwards.
+// The query is a bidirectional Dijkstra that only goes upwards
+// (to later contracted nodes) from both ends; shortcuts are unpacked
+// recursively through their middle node into the original lines.
+// Node ids are those of the graph the hierarchy was built on.
+// ------------------------------------------------------------
+class ContractionHierarchy
+{
+public:
+    // Arc of the hierarchy: original line (middle = CH_NO_MIDDLE)
+    // or shortcut over 'middle'
+    struct Arc {
+        uint32_t node;      // Head of an upward arc, tail of a downward arc
+        double weight;
+        uint32_t middle;
+        uint32_t lineId;
+    };
+
+private:
+    vector<uint32_t> rank;          // Contraction position of every node
+    vector<uint32_t> upOffsets;     // Arcs u -> higher node, per u
+    vector<Arc> upArcs;
+    vector<uint32_t> downOffsets;   // Arcs higher node -> u, per u
+    vector<Arc> downArcs;
+    size_t shortcuts = 0;
+    uint64_t fingerprint = 0;
+
+    // Appends the original lines of arc from -> to (through middle) to a path
+    void unpack(uint32_t from, uint32_t to, uint32_t middle, uint32_t lineId,
+        vector<uint32_t>& nodes, vector<uint32_t>& lines) const;
+
+    friend class CHQuery;
+    friend class TransitNodeRouting;
+    friend class TransitNodeQuery;
+
+public:
+    ContractionHierarchy() : upOffsets(1, 0), downOffsets(1, 0) {}
+
+    // Contracts the whole graph using all cores (threads = 0) or the given number of threads
+    template <typename GraphType>
+    void build(const GraphType& graph, uint64_t graphFingerprint, unsigned threads = 0);
+
+    bool empty() const { return rank.empty(); }
+    size_t nodeCount() const { return rank.size(); }
+    size_t arcCount() const { return upArcs.size() + downArcs.size(); }
+    size_t shortcutCount() const { return shortcuts; }
+    uint32_t getRank(uint32_t v) const { return rank[v]; }
+    uint64_t getFingerprint() const { return fingerprint; }
+
+    // Bytes used by the hierarchy
+    size_t memoryUsage() const {
+        return (rank.size() + upOffsets.size() + downOffsets.size()) * sizeof(uint32_t)
+            + (upArcs.size() + downArcs.size()) * sizeof(Arc);
+    }
+};
+
+// ------------------------------------------------------------
+// Point-to-point query on a ContractionHierarchy: bidirectional
+// upward Dijkstra, stopped once both queue heads reach the best
+// meeting distance; the path is unpacked into original lines.
+// ------------------------------------------------------------
+class CHQuery
+{
+public:
+    typedef uint32_t NodeId;
+    typedef double Weight;
+
+private:
+    const ContractionHierarchy& hierarchy;
+
+    // Index 0 = forward (upward from the source), 1 = backward (upward from the target)
+    vector<double> dist[2];
+    vector<uint32_t> parent[2];     // Arc index the node was reached through
+    vector<uint32_t> touched[2];
+    size_t settled = 0;
+
+public:
+    explicit CHQuery(const ContractionHierarchy& hierarchy);
+
+    // Shortest path from source to target
+    PathResult<uint32_t, double> run(uint32_t source, uint32_t target);
+
+    // Number of nodes settled by both searches of the last run
+    size_t settledCount() const { return settled; }
+};
+
+extern template void ContractionHierarchy::build(const Graph<size_t, double>&, uint64_t, unsigned);
+extern template void ContractionHierarchy::build(const ProfileGraph<Graph<size_t, double>>&, uint64_t, unsigned);
+
+#endif
@@ -0,0 +1,378 @@
+#include "CustomizableHierarchy.h"
+#include "ParallelFor.h"
+#include <limits>
+#include <algorithm>
+#include <iterator>
+#include <iostream>
+
+// Levels with fewer nodes are customized on one thread
+#define CCH_PARALLEL_MIN_LEVEL 1024
+
+// Marks the halves of a cell split at the median of one axis: side 1 = lower, 2 = upper
+static void splitAtMedian(const PointStore& points, vector<uint32_t>& cell, bool alongX, vector<uint8_t>& side)
+{
+    auto coordinate = [&](uint32_t v) { return alongX ? points.getX(v) : points.getY(v); };
+    auto middle = cell.begin() + cell.size() / 2;
+    nth_element(cell.begin(), middle, cell.end(), [&](uint32_t a, uint32_t b) { return coordinate(a) < coordinate(b); });
+    for (auto it = cell.begin(); it != middle; ++it) side[*it] = 1;
+    for (auto it = middle; it != cell.end(); ++it) side[*it] = 2;
+}
+
+// -----------------------------------------------------------
+// Nested dissection of one cell: split at the median of an axis;
+// the points of one half with a neighbour in the other half form
+// the separator. Both axes and both halves are tried, the smallest
+// separator wins. Both parts are ordered first, the separator last
+// (contracted after everything it separates).
+// -----------------------------------------------------------
+static void dissect(const PointStore& points, const vector<vector<uint32_t>>& adjacency,
+    vector<uint32_t>& cell, vector<uint8_t>& side, vector<uint32_t>& order)
+{
+    if (cell.size() <= CCH_LEAF_SIZE) {
+        order.insert(order.end(), cell.begin(), cell.end());
+        return;
+    }
+
+    auto onCut = [&](uint32_t v) {
+        for (uint32_t w : adjacency[v]) {
+            if (side[w] != 0 && side[w] != side[v]) return true;
+        }
+        return false;
+    };
+
+    size_t bestSize = SIZE_MAX;
+    bool bestAlongX = true;
+    uint8_t bestHalf = 1;
+    for (bool alongX : { true, false }) {
+        splitAtMedian(points, cell, alongX, side);
+        size_t size[3] = { 0, 0, 0 };
+        for (uint32_t v : cell) size[side[v]] += onCut(v);
+        for (uint8_t half : { 1, 2 }) {
+            if (size[half] < bestSize) {
+                bestSize = size[half];
+                bestAlongX = alongX;
+                bestHalf = half;
+            }
+        }
+        for (uint32_t v : cell) side[v] = 0;
+    }
+
+    splitAtMedian(points, cell, bestAlongX, side);
+    vector<uint32_t> parts[2], separator;
+    for (uint32_t v : cell) {
+        if (side[v] == bestHalf && onCut(v)) separator.push_back(v);
+        else parts[side[v] - 1].push_back(v);
+    }
+    for (uint32_t v : cell) side[v] = 0;
+    vector<uint32_t>().swap(cell);
+
+    dissect(points, adjacency, parts[0], side, order);
+    dissect(points, adjacency, parts[1], side, order);
+    order.insert(order.end(), separator.begin(), separator.end());
+}
+
+template <typename GraphType>
+void CustomizableHierarchy::prepare(const PointStore& points, const GraphType& graph)
+{
+    size_t n = graph.nodeCount();
+
+    // Topology without directions
+    vector<vector<uint32_t>> adjacency(n);
+    for (size_t u = 0; u < n; u++) {
+        graph.forEachArc(static_cast<typename GraphType::NodeType>(u), [&](auto v, auto, auto) {
+            if (v == u) return;
+            adjacency[u].push_back(static_cast<uint32_t>(v));
+            adjacency[v].push_back(static_cast<uint32_t>(u));
+        });
+    }
+    for (auto& list : adjacency) {
+        sort(list.begin(), list.end());
+        list.erase(unique(list.begin(), list.end()), list.end());
+    }
+
+    // Order: free slots first (isolated), then the dissection of the stored points
+    vector<uint32_t> order, cell;
+    for (uint32_t v = 0; v < n; v++) (v < points.capacity() && points.isOccupied(v) ? cell : order).push_back(v);
+    vector<uint8_t> side(n, 0);
+    dissect(points, adjacency, cell, side, order);
+
+    rankOf.assign(n, 0);
+    nodeOf = order;
+    for (uint32_t r = 0; r < n; r++) rankOf[order[r]] = r;
+
+    // Symbolic contraction: the upper neighbours of every rank become
+    // a clique, i.e. join the upper neighbours of the lowest of them
+    vector<vector<uint32_t>> upper(n);
+    for (uint32_t r = 0; r < n; r++) {
+        for (uint32_t v : adjacency[nodeOf[r]]) {
+            if (rankOf[v] > r) upper[r].push_back(rankOf[v]);
+        }
+        sort(upper[r].begin(), upper[r].end());
+    }
+    vector<vector<uint32_t>>().swap(adjacency);
+
+    parent.assign(n, UINT32_MAX);
+    vector<uint32_t> merged;
+    for (uint32_t r = 0; r < n; r++) {
+        if (upper[r].empty()) continue;
+        uint32_t p = upper[r][0];
+        parent[r] = p;
+        merged.clear();
+        set_union(upper[p].begin(), upper[p].end(), upper[r].begin() + 1, upper[r].end(), back_inserter(merged));
+        upper[p].swap(merged);
+    }
+
+    upOffsets.assign(n + 1, 0);
+    for (uint32_t r = 0; r < n; r++) upOffsets[r + 1] = upOffsets[r] + static_cast<uint32_t>(upper[r].size());
+    upHeads.clear();
+    upHeads.reserve(upOffsets[n]);
+    for (auto& list : upper) {
+        upHeads.insert(upHeads.end(), list.begin(), list.end());
+        vector<uint32_t>().swap(list);
+    }
+
+    // Arcs grouped by head (tails in increasing order)
+    lowerOffsets.assign(n + 1, 0);
+    for (uint32_t h : upHeads) lowerOffsets[h + 1]++;
+    for (size_t r = 0; r < n; r++) lowerOffsets[r + 1] += lowerOffsets[r];
+    lowerArcs.resize(upHeads.size());
+    lowerTails.resize(upHeads.size());
+    vector<uint32_t> fill(lowerOffsets.begin(), lowerOffsets.end() - 1);
+    for (uint32_t r = 0; r < n; r++) {
+        for (uint32_t a = upOffsets[r]; a < upOffsets[r + 1]; a++) {
+            uint32_t slot = fill[upHeads[a]]++;
+            lowerArcs[slot] = a;
+            lowerTails[slot] = r;
+        }
+    }
+
+    // Level = height in the elimination tree; a level only depends on lower ones
+    vector<uint32_t> level(n, 0);
+    uint32_t levels = n > 0 ? 1 : 0;
+    for (uint32_t r = 0; r < n; r++) {
+        for (uint32_t a = upOffsets[r]; a < upOffsets[r + 1]; a++) level[upHeads[a]] = max(level[upHeads[a]], level[r] + 1);
+        levels = max(levels, level[r] + 1);
+    }
+    levelOffsets.assign(levels + 1, 0);
+    for (uint32_t r = 0; r < n; r++) levelOffsets[level[r] + 1]++;
+    for (uint32_t l = 0; l < levels; l++) levelOffsets[l + 1] += levelOffsets[l];
+    levelRanks.resize(n);
+    fill.assign(levelOffsets.begin(), levelOffsets.end() - 1);
+    for (uint32_t r = 0; r < n; r++) levelRanks[fill[level[r]]++] = r;
+
+    size_t m = upHeads.size();
+    upWeight.assign(m, numeric_limits<double>::infinity());
+    downWeight.assign(m, numeric_limits<double>::infinity());
+    upMiddle.assign(m, CCH_NO_MIDDLE);
+    downMiddle.assign(m, CCH_NO_MIDDLE);
+    upLine.assign(m, UINT32_MAX);
+    downLine.assign(m, UINT32_MAX);
+    fingerprint = 0;
+    customized = false;
+}
+
+uint32_t CustomizableHierarchy::findArc(uint32_t lower, uint32_t higher) const
+{
+    auto first = upHeads.begin() + upOffsets[lower];
+    auto last = upHeads.begin() + upOffsets[lower + 1];
+    auto it = lower_bound(first, last, higher);
+    return it != last && *it == higher ? static_cast<uint32_t>(it - upHeads.begin()) : UINT32_MAX;
+}
+
+template <typename GraphType>
+bool CustomizableHierarchy::customize(const GraphType& graph, uint64_t graphFingerprint, unsigned threads)
+{
+    size_t n = nodeCount();
+    customized = false;
+    if (empty() || graph.nodeCount() != n) {
+        cout << "CCH Error: Points changed since the hierarchy was prepared\n";
+        return false;
+    }
+    if (threads == 0) threads = workerCount(upHeads.size());
+
+    // Original lines: a direction is only written from its tail, so nodes run in parallel
+    vector<uint8_t> missing(threads, 0);
+    parallelChunks(n, threads, [&](unsigned, size_t begin, size_t end) {
+        for (size_t u = begin; u < end; u++) {
+            uint32_t ru = rankOf[u];
+            for (uint32_t a = upOffsets[ru]; a < upOffsets[ru + 1]; a++) {
+                upWeight[a] = numeric_limits<double>::infinity();
+                upMiddle[a] = CCH_NO_MIDDLE;
+                upLine[a] = UINT32_MAX;
+            }
+            for (uint32_t i = lowerOffsets[ru]; i < lowerOffsets[ru + 1]; i++) {
+                downWeight[lowerArcs[i]] = numeric_limits<double>::infinity();
+                downMiddle[lowerArcs[i]] = CCH_NO_MIDDLE;
+                downLine[lowerArcs[i]] = UINT32_MAX;
+            }
+        }
+    });
+    parallelChunks(n, threads, [&](unsigned chunk, size_t begin, size_t end) {
+        for (size_t u = begin; u < end; u++) {
+            uint32_t ru = rankOf[u];
+            graph.forEachArc(static_cast<typename GraphType::NodeType>(u), [&](auto v, auto weight, auto lineId) {
+                uint32_t rv = rankOf[v];
+                if (rv == ru) return;
+                uint32_t a = ru < rv ? findArc(ru, rv) : findArc(rv, ru);
+                if (a == UINT32_MAX) {
+                    missing[chunk] = 1;
+                    return;
+                }
+                double w = static_cast<double>(weight);
+                if (ru < rv && w < upWeight[a]) {
+                    upWeight[a] = w;
+                    upLine[a] = static_cast<uint32_t>(lineId);
+                }
+                else if (ru > rv && w < downWeight[a]) {
+                    downWeight[a] = w;
+                    downLine[a] = static_cast<uint32_t>(lineId);
+                }
+            });
+        }
+    });
+    if (find(missing.begin(), missing.end(), 1) != missing.end()) {
+        cout << "CCH Error: Lines changed since the hierarchy was prepared\n";
+        return false;
+    }
+
+    // Lower triangles v < x < y: x -> y may go x -> v -> y (and back).
+    // Every node only writes its own upward arcs and reads those of
+    // lower levels, so one level runs in parallel.
+    vector<vector<uint32_t>> slots(threads, vector<uint32_t>(n, UINT32_MAX));
+    for (size_t l = 0; l + 1 < levelOffsets.size(); l++) {
+        size_t first = levelOffsets[l];
+        size_t count = levelOffsets[l + 1] - first;
+        parallelChunks(count, count >= CCH_PARALLEL_MIN_LEVEL ? threads : 1, [&](unsigned chunk, size_t begin, size_t end) {
+            vector<uint32_t>& slot = slots[chunk];
+            for (size_t i = first + begin; i < first + end; i++) {
+                uint32_t x = levelRanks[i];
+                for (uint32_t b = upOffsets[x]; b < upOffsets[x + 1]; b++) slot[upHeads[b]] = b;
+
+                for (uint32_t j = lowerOffsets[x]; j < lowerOffsets[x + 1]; j++) {
+                    uint32_t vx = lowerArcs[j];
+                    uint32_t v = lowerTails[j];
+                    for (uint32_t vy = vx + 1; vy < upOffsets[v + 1]; vy++) {
+                        uint32_t b = slot[upHeads[vy]];
+                        double viaUp = downWeight[vx] + upWeight[vy];
+                        if (viaUp < upWeight[b]) {
+                            upWeight[b] = viaUp;
+                            upMiddle[b] = v;
+                        }
+                        double viaDown = downWeight[vy] + upWeight[vx];
+                        if (viaDown < downWeight[b]) {
+                            downWeight[b] = viaDown;
+                            downMiddle[b] = v;
+                        }
+                    }
+                }
+
+                for (uint32_t b = upOffsets[x]; b < upOffsets[x + 1]; b++) slot[upHeads[b]] = UINT32_MAX;
+            }
+        });
+    }
+
+    fingerprint = graphFingerprint;
+    customized = true;
+    return true;
+}
+
+void CustomizableHierarchy::unpack(uint32_t from, uint32_t to, vector<uint32_t>& nodes, vector<uint32_t>& lines) const
+{
+    bool up = from < to;
+    uint32_t a = up ? findArc(from, to) : findArc(to, from);
+    uint32_t middle = up ? upMiddle[a] : downMiddle[a];
+    if (middle == CCH_NO_MIDDLE) {
+        nodes.push_back(nodeOf[to]);
+        lines.push_back(up ? upLine[a] : downLine[a]);
+        return;
+    }
+    unpack(from, middle, nodes, lines);
+    unpack(middle, to, nodes, lines);
+}
+
+CCHQuery::CCHQuery(const CustomizableHierarchy& hierarchy)
+    : hierarchy(hierarchy)
+{
+    for (int side = 0; side < 2; side++) {
+        dist[side].assign(hierarchy.nodeCount(), numeric_limits<double>::infinity());
+        parentRank[side].assign(hierarchy.nodeCount(), UINT32_MAX);
+    }
+}
+
+PathResult<uint32_t, double> CCHQuery::run(uint32_t source, uint32_t target)
+{
+    const double unreached = numeric_limits<double>::infinity();
+    const CustomizableHierarchy& h = hierarchy;
+    PathResult<uint32_t, double> result;
+    settled = 0;
+
+    // Reset the chains of the previous run (nothing else was written)
+    for (int side = 0; side < 2; side++) {
+        for (uint32_t v = chainStart[side]; v != UINT32_MAX; v = h.parent[v]) {
+            dist[side][v] = unreached;
+            parentRank[side][v] = UINT32_MAX;
+        }
+        chainStart[side] = UINT32_MAX;
+    }
+    if (source >= h.nodeCount() || target >= h.nodeCount()) return result;
+
+    // Upward along the elimination tree: forward with 'up', backward with 'down' weights
+    uint32_t start[2] = { h.rankOf[source], h.rankOf[target] };
+    auto scan = [&](int side, uint32_t x) {
+        const vector<double>& weight = side == 0 ? h.upWeight : h.downWeight;
+        double d = dist[side][x];
+        settled++;
+        for (uint32_t a = h.upOffsets[x]; a < h.upOffsets[x + 1]; a++) {
+            uint32_t y = h.upHeads[a];
+            if (d + weight[a] < dist[side][y]) {
+                dist[side][y] = d + weight[a];
+                parentRank[side][y] = x;
+            }
+        }
+    };
+    for (int side = 0; side < 2; side++) {
+        chainStart[side] = start[side];
+        dist[side][start[side]] = 0.0;
+    }
+
+    // Below the lowest common ancestor the chains are disjoint: advance the lower one
+    uint32_t v[2] = { start[0], start[1] };
+    while (v[0] != v[1]) {
+        int side = v[0] < v[1] ? 0 : 1;
+        if (dist[side][v[side]] != unreached) scan(side, v[side]);
+        v[side] = h.parent[v[side]];
+    }
+
+    // Common ancestors: every one is a meeting candidate, and a side
+    // already at least as far as the best meeting cannot improve it
+    double best = unreached;
+    uint32_t meeting = UINT32_MAX;
+    for (uint32_t u = v[0]; u != UINT32_MAX; u = h.parent[u]) {
+        if (dist[0][u] + dist[1][u] < best) {
+            best = dist[0][u] + dist[1][u];
+            meeting = u;
+        }
+        for (int side = 0; side < 2; side++) {
+            if (dist[side][u] < best) scan(side, u);
+        }
+    }
+    if (meeting == UINT32_MAX) return result;
+    result.found = true;
+    result.distance = best;
+
+    vector<uint32_t> up;
+    for (uint32_t v = meeting; v != start[0]; v = parentRank[0][v]) up.push_back(v);
+    result.nodes.push_back(source);
+    uint32_t from = start[0];
+    for (auto it = up.rbegin(); it != up.rend(); ++it) {
+        h.unpack(from, *it, result.nodes, result.lines);
+        from = *it;
+    }
+    for (uint32_t v = meeting; v != start[1]; v = parentRank[1][v]) h.unpack(v, parentRank[1][v], result.nodes, result.lines);
+    return result;
+}
+
+template void CustomizableHierarchy::prepare(const PointStore&, const Graph<size_t, double>&);
+template void CustomizableHierarchy::prepare(const PointStore&, const ProfileGraph<Graph<size_t, double>>&);
+template bool CustomizableHierarchy::customize(const Graph<size_t, double>&, uint64_t, unsigned);
+template bool CustomizableHierarchy::customize(const ProfileGraph<Graph<size_t, double>>&, uint64_t, unsigned);
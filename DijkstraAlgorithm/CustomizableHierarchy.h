@@ -0,0 +1,137 @@
+#pragma once
+
+#ifndef CUSTOMIZABLEHIERARCHY_H
+#define CUSTOMIZABLEHIERARCHY_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "PointStore.h"
+#include "Graph.h"
+#include "ShortestPathQuery.h"
+
+using namespace std;
+
+// Cells of at most this many points are not dissected further
+#define CCH_LEAF_SIZE 16
+
+// Marks a direction that is an original line (or missing), not a shortcut
+#define CCH_NO_MIDDLE UINT32_MAX
+
+// ------------------------------------------------------------
+// Customizable Contraction Hierarchy (CCH).
+// Splits the contraction hierarchy into two phases:
+//  - prepare: metric independent. Nested dissection over the point
+//    coordinates (recursive bisection of the longer axis, the points
+//    next to the cut become a separator contracted after both halves)
+//    gives the node order; contracting the topology in that order
+//    adds every possible shortcut (no witness searches).
+//  - customize: applies the current weights to that fixed structure.
+//    Every shortcut takes the best of its lower triangles; nodes of
+//    one level of the elimination tree are independent and run in
+//    parallel, so a weight change costs a customization, not a new
+//    preprocessing.
+// Arcs store both directions, so directed lines work. Internally
+// nodes are numbered by rank; the query maps ids at the boundary.
+// ------------------------------------------------------------
+class CustomizableHierarchy
+{
+private:
+    vector<uint32_t> rankOf;        // Node id -> rank
+    vector<uint32_t> nodeOf;        // Rank -> node id
+    vector<uint32_t> parent;        // Elimination tree: lowest upper neighbour (UINT32_MAX for roots)
+
+    // Upward arcs (lower rank -> higher rank) per rank, heads sorted
+    vector<uint32_t> upOffsets;
+    vector<uint32_t> upHeads;
+
+    // Arcs into every rank from lower ranks (arc index and tail), for customization
+    vector<uint32_t> lowerOffsets;
+    vector<uint32_t> lowerArcs;
+    vector<uint32_t> lowerTails;
+
+    // Ranks grouped by elimination tree level (customization order)
+    vector<uint32_t> levelOffsets;
+    vector<uint32_t> levelRanks;
+
+    // Metric per arc: 'up' is lower -> higher, 'down' is higher -> lower.
+    // A direction is a shortcut over rank 'middle' or the line 'lineId'.
+    vector<double> upWeight, downWeight;
+    vector<uint32_t> upMiddle, downMiddle;
+    vector<uint32_t> upLine, downLine;
+    uint64_t fingerprint = 0;
+    bool customized = false;
+
+    // Index of the arc between ranks lower < higher (UINT32_MAX if none)
+    uint32_t findArc(uint32_t lower, uint32_t higher) const;
+
+    // Appends the original lines of the arc from -> to (ranks) to a path
+    void unpack(uint32_t from, uint32_t to, vector<uint32_t>& nodes, vector<uint32_t>& lines) const;
+
+    friend class CCHQuery;
+
+public:
+    CustomizableHierarchy() : upOffsets(1, 0), lowerOffsets(1, 0), levelOffsets(1, 0) {}
+
+    // Metric independent phase: node order and shortcut structure from coordinates and topology
+    template <typename GraphType>
+    void prepare(const PointStore& points, const GraphType& graph);
+
+    // Applies the graph's weights using all cores (threads = 0) or the given number of threads.
+    // False if the graph has points or lines outside the prepared topology.
+    template <typename GraphType>
+    bool customize(const GraphType& graph, uint64_t graphFingerprint, unsigned threads = 0);
+
+    bool empty() const { return rankOf.empty(); }
+    bool isCustomized() const { return customized; }
+    size_t nodeCount() const { return rankOf.size(); }
+    size_t arcCount() const { return upHeads.size(); }
+    size_t levelCount() const { return levelOffsets.size() - 1; }
+    uint64_t getFingerprint() const { return fingerprint; }
+
+    // Bytes used by structure and metric
+    size_t memoryUsage() const {
+        return (rankOf.size() + nodeOf.size() + parent.size() + upOffsets.size() + upHeads.size()
+            + lowerOffsets.size() + lowerArcs.size() + lowerTails.size() + levelOffsets.size() + levelRanks.size()
+            + upMiddle.size() + downMiddle.size() + upLine.size() + downLine.size()) * sizeof(uint32_t)
+            + (upWeight.size() + downWeight.size()) * sizeof(double);
+    }
+};
+
+// ------------------------------------------------------------
+// Point-to-point query on a customized CCH. Both searches walk
+// the elimination tree upwards from their end (all upper neighbours
+// of a node are its ancestors), so there is no priority queue;
+// the best meeting node lies on both ancestor chains.
+// ------------------------------------------------------------
+class CCHQuery
+{
+public:
+    typedef uint32_t NodeId;
+    typedef double Weight;
+
+private:
+    const CustomizableHierarchy& hierarchy;
+
+    // Index 0 = forward (from the source), 1 = backward (from the target); ranks
+    vector<double> dist[2];
+    vector<uint32_t> parentRank[2];     // Rank the node was reached from
+    uint32_t chainStart[2] = { UINT32_MAX, UINT32_MAX };    // Ranks the last run started from
+    size_t settled = 0;
+
+public:
+    explicit CCHQuery(const CustomizableHierarchy& hierarchy);
+
+    // Shortest path from source to target (node ids)
+    PathResult<uint32_t, double> run(uint32_t source, uint32_t target);
+
+    // Number of nodes scanned by both searches of the last run
+    size_t settledCount() const { return settled; }
+};
+
+extern template void CustomizableHierarchy::prepare(const PointStore&, const Graph<size_t, double>&);
+extern template void CustomizableHierarchy::prepare(const PointStore&, const ProfileGraph<Graph<size_t, double>>&);
+extern template bool CustomizableHierarchy::customize(const Graph<size_t, double>&, uint64_t, unsigned);
+extern template bool CustomizableHierarchy::customize(const ProfileGraph<Graph<size_t, double>>&, uint64_t, unsigned);
+
+#endif
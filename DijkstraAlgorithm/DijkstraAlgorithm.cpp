@@ -3,6 +3,8 @@
 
 #include "Point.h"
 #include "Line.h"
+#include "GraphStorage.h"
+#include "VisualState.h"
 #include "FileProcesses.h"
 #include "WindowDraw.h"
 #include "Interface.h"
@@ -19,8 +21,8 @@ using namespace std;
 
 int main()
 {
-    vector<Line> lines;
-    vector<Point> points;
+    GraphStorage graph;
+    VisualState visualState; // Algorithm animation overlay, drawn on top of the graph
 
     // Create main application window
     sf::RenderWindow window(sf::VideoMode({ 800, 600 }), "SFML Multithreading");
@@ -32,7 +34,7 @@ int main()
     window.setView(view);
 
     // Start console interface in a separate thread
-    thread consoleThread(MainInterface, ref(points), ref(lines));
+    thread consoleThread(MainInterface, ref(graph), ref(visualState));
 
     // Main SFML loop
     while (window.isOpen())
@@ -61,12 +63,16 @@ int main()
         window.clear(sf::Color::White);
 
         {
-            // Synchronize access to shared vectors
-            lock_guard<mutex> lock(dataMutex);
+            // Immutable graph version: edits publish new ones without waiting for the frame
+            shared_ptr<const GraphVersion> version = graph.current();
+            lock_guard<mutex> overlayLock(visualState.getMutex());
+
+            const PointStore& points = version->getPoints();
+            const LineStore& lines = version->getLines();
 
             // Draw lines, points, labels and weights
-            drawLines(lines, points, window);
-            drawPoints(points, window);
+            drawLines(lines, points, visualState, window);
+            drawPoints(points, visualState, window);
             if (LABEL_SHOW) drawLabels(points, window);
             if (WEIGHT_SHOW) drawEdgeWeights(lines, points, window);
         }
@@ -0,0 +1,130 @@
+#include "DynamicAdjacency.h"
+#include <utility>
+
+// Compaction starts once the delta exceeds this many arcs plus 1/8 of the base
+#define COMPACTION_MIN_DELTA 1024
+#define COMPACTION_FRACTION 8
+
+// Arena bytes for copying the lists of a delta chunk (times two for vector growth)
+template <typename Lists>
+static size_t copyArenaBytes(const Lists& lists)
+{
+    size_t bytes = 0;
+    for (const auto& list : lists) bytes += list.size() * sizeof(list[0]);
+    return 2 * bytes;
+}
+
+DynamicAdjacency::DynamicAdjacency()
+    : base(make_shared<AdjacencyGraph>())
+{
+}
+
+DynamicAdjacency::DeltaChunk::DeltaChunk(const DeltaChunk& other)
+    : arena(copyArenaBytes(other.lists))
+{
+    lists.reserve(COLUMN_CHUNK_SIZE);
+    for (const pmr::vector<Arc>& list : other.lists) {
+        lists.emplace_back(list.begin(), list.end(), arena.resource());
+    }
+}
+
+DynamicAdjacency::DeltaChunk& DynamicAdjacency::writableChunk(size_t c)
+{
+    unshareChunk(added[c]);
+    return *added[c];
+}
+
+void DynamicAdjacency::resetDelta(size_t nodeIds)
+{
+    added.clear();
+    nodes = 0;
+    addedCount = 0;
+    if (nodeIds > 0) addNode(static_cast<uint32_t>(nodeIds - 1));
+}
+
+void DynamicAdjacency::addNode(uint32_t id)
+{
+    while (nodes <= id) {
+        if ((nodes & (COLUMN_CHUNK_SIZE - 1)) == 0) added.push_back(make_shared<DeltaChunk>());
+        DeltaChunk& chunk = writableChunk(added.size() - 1);
+        chunk.lists.emplace_back(chunk.arena.resource());
+        nodes++;
+    }
+}
+
+void DynamicAdjacency::addLine(uint32_t lineId, uint32_t start, uint32_t end, double weight, bool directed)
+{
+    addNode(start > end ? start : end);
+    writableArcs(start).push_back({ end, weight, lineId, directed ? OUTGOING : BOTH_WAYS });
+    writableArcs(end).push_back({ start, weight, lineId, directed ? INCOMING : BOTH_WAYS });
+    addedCount += 2;
+}
+
+void DynamicAdjacency::removeArc(uint32_t u, uint32_t lineId)
+{
+    // Recently inserted arcs first, they are the most likely to be edited again
+    const pmr::vector<Arc>& arcs = addedArcs(u);
+    for (size_t i = 0; i < arcs.size(); i++) {
+        if (arcs[i].lineId == lineId) {
+            pmr::vector<Arc>& list = writableArcs(u);
+            list[i] = list.back();
+            list.pop_back();
+            addedCount--;
+            return;
+        }
+    }
+
+    if (u >= base->nodeCount()) return;
+    for (size_t arc = base->begin(u); arc < base->end(u); arc++) {
+        if (!as_const(deadArcs)[arc] && base->lineId(arc) == lineId) {
+            deadArcs[arc] = 1;
+            deadCount++;
+            break;
+        }
+    }
+
+    // With one-way lines the reverse CSR has its own copy of the arc
+    if (base->isSymmetric()) return;
+    for (size_t arc = base->reverseBegin(u); arc < base->reverseEnd(u); arc++) {
+        if (!as_const(deadReverseArcs)[arc] && base->reverseLineId(arc) == lineId) {
+            deadReverseArcs[arc] = 1;
+            return;
+        }
+    }
+}
+
+void DynamicAdjacency::removeLine(uint32_t lineId, uint32_t start, uint32_t end)
+{
+    removeArc(start, lineId);
+    removeArc(end, lineId);
+}
+
+bool DynamicAdjacency::needsCompaction() const
+{
+    return addedCount + deadCount > COMPACTION_MIN_DELTA + base->arcCount() / COMPACTION_FRACTION;
+}
+
+void DynamicAdjacency::compact(const PointStore& points, const LineStore& lines)
+{
+    // Parallel build from the line list (uses all cores for large graphs)
+    base = make_shared<AdjacencyGraph>(points.capacity(), edgeRecords(lines));
+    deadArcs.assign(base->arcCount(), 0);
+    deadReverseArcs.assign(base->isSymmetric() ? 0 : base->reverseArcCount(), 0);
+    deadCount = 0;
+
+    resetDelta(points.capacity() > nodes ? points.capacity() : nodes);
+}
+
+void DynamicAdjacency::clear()
+{
+    base = make_shared<AdjacencyGraph>();
+    deadArcs.clear();
+    deadReverseArcs.clear();
+    deadCount = 0;
+    resetDelta(0);
+}
+
+void DynamicAdjacency::reserve(size_t nodeIds)
+{
+    added.reserve((nodes + nodeIds + COLUMN_CHUNK_SIZE - 1) >> COLUMN_CHUNK_BITS);
+}
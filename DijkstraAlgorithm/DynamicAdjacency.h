@@ -0,0 +1,141 @@
+#pragma once
+
+#ifndef DYNAMICADJACENCY_H
+#define DYNAMICADJACENCY_H
+
+#include <vector>
+#include <memory>
+#include <memory_resource>
+#include <cstdint>
+#include "Graph.h"
+#include "GraphArena.h"
+#include "PointStore.h"
+#include "Line.h"
+#include "ChunkedColumn.h"
+
+using namespace std;
+
+// ------------------------------------------------------------
+// Adjacency that follows interactive edits without full rebuilds.
+// Queries read a compact CSR base plus a small delta:
+//  - arcs inserted since the last compaction live in per-node lists,
+//  - arcs of deleted lines are tombstoned in the base.
+// Inserting or deleting a line costs O(degree). Once the delta grows
+// past a fraction of the base, compact() folds it back into a fresh
+// CSR, so the rebuild cost is amortized over many edits.
+// Tombstones and delta lists are chunked (COLUMN_CHUNK_SIZE entries
+// or nodes per chunk), and each chunk of delta lists allocates from
+// its own arena, dropped with a single release at compaction.
+// Copies (for graph versions) share the immutable base and every
+// chunk; an edit copies only the chunks it writes.
+// A directed line is stored at both endpoints as well, marked as
+// outgoing at its start and incoming at its end, so forEachArc and
+// forEachReverseArc see it in the right direction only.
+// ------------------------------------------------------------
+class DynamicAdjacency
+{
+private:
+    // Direction of a delta arc as seen from the node listing it
+    enum ArcDirection : uint8_t { BOTH_WAYS, OUTGOING, INCOMING };
+
+    struct Arc {
+        uint32_t target;            // Other endpoint of the line
+        double weight;
+        uint32_t lineId;
+        ArcDirection direction;
+    };
+
+    // Delta lists of COLUMN_CHUNK_SIZE consecutive nodes
+    struct DeltaChunk {
+        GraphArena arena;                   // Backs the lists (declared first, they must go before it)
+        vector<pmr::vector<Arc>> lists;
+
+        DeltaChunk() { lists.reserve(COLUMN_CHUNK_SIZE); }
+        DeltaChunk(const DeltaChunk& other);    // Copies the lists into a new arena
+    };
+
+    shared_ptr<const AdjacencyGraph> base; // Read-optimized adjacency at the last compaction
+    ChunkedColumn<uint8_t> deadArcs;        // 1 for base arcs whose line was deleted since
+    ChunkedColumn<uint8_t> deadReverseArcs; // Same for the base reverse arcs (empty if the base is symmetric)
+    vector<shared_ptr<DeltaChunk>> added;   // Node id -> arcs inserted since the last compaction, by chunk
+    size_t nodes = 0;               // Number of node ids with a delta list
+    size_t addedCount = 0;          // Number of arcs in 'added'
+    size_t deadCount = 0;           // Number of tombstoned base arcs
+
+    const pmr::vector<Arc>& addedArcs(uint32_t u) const {
+        return added[u >> COLUMN_CHUNK_BITS]->lists[u & (COLUMN_CHUNK_SIZE - 1)];
+    }
+
+    // Delta chunk c for writing, copied first if it is shared
+    DeltaChunk& writableChunk(size_t c);
+
+    pmr::vector<Arc>& writableArcs(uint32_t u) {
+        return writableChunk(u >> COLUMN_CHUNK_BITS).lists[u & (COLUMN_CHUNK_SIZE - 1)];
+    }
+
+    // Removes the arcs of 'lineId' from the adjacency of node u
+    void removeArc(uint32_t u, uint32_t lineId);
+
+    // Drops the delta lists (and their arenas) and starts empty ones for 'nodes' node ids
+    void resetDelta(size_t nodeIds);
+
+public:
+    DynamicAdjacency();
+    DynamicAdjacency(const DynamicAdjacency& other) = default;
+    DynamicAdjacency& operator=(const DynamicAdjacency&) = delete;
+
+    // Number of node ids covered (at least the point capacity seen so far)
+    size_t nodeCount() const { return nodes; }
+
+    // Makes room for a new node id
+    void addNode(uint32_t id);
+
+    // Inserts the arcs of a line (start->end only if directed), O(1)
+    void addLine(uint32_t lineId, uint32_t start, uint32_t end, double weight, bool directed = false);
+
+    // Removes the arcs of a line, O(degree)
+    void removeLine(uint32_t lineId, uint32_t start, uint32_t end);
+
+    // True once the delta is large enough to be worth folding into the base
+    bool needsCompaction() const;
+
+    // Rebuilds the CSR base from the current points/lines and drops the delta
+    void compact(const PointStore& points, const LineStore& lines);
+
+    // Drops everything
+    void clear();
+
+    // Pre-allocates the per-node list table for a bulk load
+    void reserve(size_t nodeIds);
+
+    // Calls f(target, weight, lineId) for every live arc of node u
+    template <typename F>
+    void forEachArc(uint32_t u, F&& f) const {
+        if (u < base->nodeCount()) {
+            for (size_t arc = base->begin(u); arc < base->end(u); arc++) {
+                if (deadArcs[arc]) continue;
+                f(static_cast<uint32_t>(base->target(arc)), base->weight(arc), static_cast<uint32_t>(base->lineId(arc)));
+            }
+        }
+        for (const Arc& a : addedArcs(u)) {
+            if (a.direction != INCOMING) f(a.target, a.weight, a.lineId);
+        }
+    }
+
+    // Calls f(source, weight, lineId) for every live arc ending in node u
+    template <typename F>
+    void forEachReverseArc(uint32_t u, F&& f) const {
+        if (u < base->nodeCount()) {
+            const ChunkedColumn<uint8_t>& dead = base->isSymmetric() ? deadArcs : deadReverseArcs;
+            for (size_t arc = base->reverseBegin(u); arc < base->reverseEnd(u); arc++) {
+                if (dead[arc]) continue;
+                f(static_cast<uint32_t>(base->source(arc)), base->reverseWeight(arc), static_cast<uint32_t>(base->reverseLineId(arc)));
+            }
+        }
+        for (const Arc& a : addedArcs(u)) {
+            if (a.direction != OUTGOING) f(a.target, a.weight, a.lineId);
+        }
+    }
+};
+
+#endif
@@ -5,21 +5,118 @@
 #include <vector>
 #include <cctype>
 #include <fstream>
+#include <sstream>
+#include <algorithm>
 
 using namespace std;
 
+// Read block size of the record pre-scan
+#define PRESCAN_BLOCK 65536
+
+// ----------------------------------------------
+// Counts the records (non-empty text lines) of a
+// file and rewinds it, used as a sizing hint
+// ----------------------------------------------
+static size_t countRecords(istream& in)
+{
+    vector<char> block(PRESCAN_BLOCK);
+    size_t records = 0;
+    bool lineHasText = false;
+
+    while (in.read(block.data(), block.size()) || in.gcount() > 0) {
+        streamsize n = in.gcount();
+        for (streamsize i = 0; i < n; i++) {
+            if (block[i] == '\n') {
+                if (lineHasText) records++;
+                lineHasText = false;
+            }
+            else if (!isspace(static_cast<unsigned char>(block[i]))) {
+                lineHasText = true;
+            }
+        }
+    }
+    if (lineHasText) records++;
+
+    in.clear();
+    in.seekg(0);
+    return records;
+}
+
+// ----------------------------------------------
+// Reads the optional direction column of a line
+// record: "->" for one-way (start to end), "<->"
+// or nothing for both ways.
+// Returns false for an unknown token
+// ----------------------------------------------
+bool readLineDirection(istream& in, bool& directed)
+{
+    directed = false;
+
+    // Only look at the rest of the current line
+    int c = in.peek();
+    while (c == ' ' || c == '\t' || c == '\r') {
+        in.get();
+        c = in.peek();
+    }
+    if (c == '\n' || c == char_traits<char>::eof()) return true;
+
+    string token;
+    in >> token;
+    if (token == LINE_ONE_WAY) directed = true;
+    else if (token != LINE_TWO_WAY) return false;
+    return true;
+}
+
+// ----------------------------------------------
+// Reads the weights of the extra profiles that
+// follow the primary weight of a line record
+// ----------------------------------------------
+static bool readExtraWeights(istream& in, vector<double>& weights)
+{
+    for (double& w : weights) {
+        if (!(in >> w)) return false;
+    }
+    return true;
+}
+
+// ----------------------------------------------
+// Reads the optional profiles header of a lines
+// file ("#profiles NAME..."). Leaves names empty
+// and the stream untouched if there is none.
+// Returns false for a malformed header
 // ----------------------------------------------
-// Load points from file into points vector
+bool readProfilesHeader(istream& in, vector<string>& names)
+{
+    names.clear();
+
+    in >> ws;
+    if (in.peek() != '#') return true;
+
+    string header, token;
+    getline(in, header);
+    istringstream fields(header);
+    fields >> token;
+    if (token != PROFILES_HEADER) return false;
+
+    while (fields >> token) {
+        if (find(names.begin(), names.end(), token) != names.end()) return false; // Duplicate name
+        names.push_back(token);
+    }
+    return !names.empty();
+}
+
+// ----------------------------------------------
+// Load points from file into the graph
 // Returns true if file was successfully read
 // ----------------------------------------------
-bool loadPointsFromFile(const std::string& filename, std::vector<Point>& points, std::vector<Line>& lines) {
+bool loadPointsFromFile(const std::string& filename, GraphStorage& graph) {
     std::ifstream in(filename);
     if (!in.is_open()) {
         return false; // File cannot be opened
     }
 
-    points.clear();
-    lines.clear(); // Also reset lines to avoid mismatched references
+    graph.clear(); // Also resets lines to avoid mismatched references
+    graph.reserve(countRecords(in), 0);
 
     Point p(0.0, 0.0, "");
 
@@ -27,8 +124,8 @@ bool loadPointsFromFile(const std::string& filename, std::vector<Point>& points,
     while (!in.eof()) {
         if (in >> p) { // Uses overloaded operator>>
             // Validate point before adding
-            if (validateNewPoint(p, points)) {
-                points.push_back(p);
+            if (validateNewPoint(p, graph)) {
+                graph.addPoint(p);
             }
         }
         else {
@@ -47,7 +144,7 @@ bool loadPointsFromFile(const std::string& filename, std::vector<Point>& points,
 // Requires that 'points' already contains valid points
 // Returns true if file successfully processed
 // -----------------------------------------------------
-bool loadLinesFromFile(const std::string& filename, std::vector<Line>& lines, std::vector<Point>& points)
+bool loadLinesFromFile(const std::string& filename, GraphStorage& graph)
 {
     std::ifstream in(filename);
     if (!in.is_open()) {
@@ -55,42 +152,52 @@ bool loadLinesFromFile(const std::string& filename, std::vector<Line>& lines, st
     }
 
     // You cannot load lines if there are no points to reference
-    if (points.empty()) {
+    if (graph.getPoints().empty()) {
         cout << "Line Error: No points available to reference (" << filename << ")" << endl;
         return false;
     }
 
-    lines.clear();
+    graph.clearLines();
+
+    // Weight columns named by the header, or a single default one
+    vector<string> profileNames;
+    if (!readProfilesHeader(in, profileNames)) {
+        cout << "Line Error: Invalid profiles header (" << filename << ")" << endl;
+        return false;
+    }
+    graph.setProfiles(profileNames);
+    graph.reserve(0, countRecords(in));
+    if (!profileNames.empty()) readProfilesHeader(in, profileNames); // Skip the header again after the rewind
 
     string startName, endName;
     double weight = 0.0;
+    vector<double> extraWeights(graph.getProfiles().count() - 1);
 
     // Read until reaching end of file
     while (!in.eof()) {
-        // Read expected format: START END WEIGHT
-        if (in >> startName >> endName >> weight) {
+        // Read expected format: START END WEIGHT [WEIGHT...] [DIRECTION]
+        bool directed = false;
+        if (in >> startName >> endName >> weight && readExtraWeights(in, extraWeights) && readLineDirection(in, directed)) {
 
             // Validate line before searching for point references
-            if (!validateNewLine(startName, endName, weight, lines, points)) {
+            if (!validateNewLine(startName, endName, weight, graph, directed)) {
                 continue; // Skip invalid line
             }
-
-            Point* start = nullptr;
-            Point* end = nullptr;
-
-            // Find pointers to matching Point objects
-            for (auto& a : points) {
-                if (a.getName() == startName) {
-                    start = &a;
-                }
-                else if (a.getName() == endName) {
-                    end = &a;
-                }
+            if (any_of(extraWeights.begin(), extraWeights.end(), [](double w) { return w < 0; })) {
+                cout << "Line Error: Weight cannot be negative" << endl;
+                continue;
             }
 
+            // Resolve names to point ids once, at the file boundary
+            uint32_t start = graph.findPoint(startName);
+            uint32_t end = graph.findPoint(endName);
+
             // If both points exist, create the line
-            if (start && end) {
-                lines.emplace_back(*start, *end, weight);
+            if (start != INVALID_POINT_ID && end != INVALID_POINT_ID) {
+                uint32_t lineId = graph.addLine(start, end, weight, directed);
+                for (size_t p = 0; p < extraWeights.size(); p++) {
+                    graph.setLineWeight(lineId, p + 1, extraWeights[p]);
+                }
             }
             else {
                 cout << "Line Error: Points not found (" << filename << ")" << endl;
@@ -104,5 +211,8 @@ bool loadLinesFromFile(const std::string& filename, std::vector<Line>& lines, st
         }
     }
 
+    // Fold the freshly loaded lines into the compact adjacency
+    graph.compact();
+
     return true;
 }
@@ -4,11 +4,23 @@
 #define FILEPROCESSES_H
 
 #include <string>
+#include <istream>
 #include <vector>
 #include "Point.h"
 #include "Line.h"
+#include "GraphStorage.h"
 
-bool loadPointsFromFile(const std::string& filename, std::vector<Point>& points, std::vector<Line>& lines);
-bool loadLinesFromFile(const std::string& filename, std::vector<Line>& lines, std::vector<Point>& points);
+// Direction column of lines.txt: "A B 5 ->" is one-way from A to B
+#define LINE_ONE_WAY "->"
+#define LINE_TWO_WAY "<->"
+
+// Optional first record of lines.txt naming the weight columns:
+// "#profiles distance time" makes every record "A B DISTANCE TIME [DIRECTION]"
+#define PROFILES_HEADER "#profiles"
+
+bool loadPointsFromFile(const std::string& filename, GraphStorage& graph);
+bool loadLinesFromFile(const std::string& filename, GraphStorage& graph);
+bool readLineDirection(std::istream& in, bool& directed);
+bool readProfilesHeader(std::istream& in, std::vector<std::string>& names);
 
 #endif
@@ -0,0 +1,244 @@
+#include "Graph.h"
+#include "ParallelFor.h"
+#include <cmath>
+#include <algorithm>
+#include <atomic>
+#include <type_traits>
+
+// -----------------------------------------------------------
+// Converts a Line weight to the graph's weight type
+// -----------------------------------------------------------
+template <typename Weight>
+static Weight convertWeight(double weight, double scale)
+{
+    if constexpr (is_integral_v<Weight>) return static_cast<Weight>(llround(weight * scale));
+    else return static_cast<Weight>(weight * scale);
+}
+
+template <typename NodeId, typename Weight>
+void Graph<NodeId, Weight>::buildArcs(size_t nodes, const LineStore& lines, const WeightProfiles* weightProfiles, double weightScale, bool reverse,
+    vector<NodeId>& offsets, vector<NodeId>& heads, vector<Weight>& weights, vector<NodeId>& lineIds)
+{
+    // Count degree of each node (shifted by one for the prefix sum)
+    offsets.assign(nodes + 1, 0);
+    for (const Line& line : lines) {
+        uint32_t from = reverse ? line.getEndId() : line.getStartId();
+        uint32_t to = reverse ? line.getStartId() : line.getEndId();
+        offsets[from + 1]++;
+        if (!line.isDirected()) offsets[to + 1]++;
+    }
+
+    // Prefix sum turns degrees into arc offsets
+    for (size_t i = 1; i < offsets.size(); i++) {
+        offsets[i] += offsets[i - 1];
+    }
+
+    size_t arcs = offsets.back();
+    size_t profiles = weightProfiles ? weightProfiles->count() : 1;
+    heads.resize(arcs);
+    weights.resize(arcs * profiles);
+    lineIds.resize(arcs);
+
+    // Scatter the arcs of every line into their slots
+    vector<NodeId> cursor(offsets.begin(), offsets.end() - 1);
+    for (auto it = lines.begin(); it != lines.end(); ++it) {
+        NodeId u = static_cast<NodeId>(reverse ? it->getEndId() : it->getStartId());
+        NodeId v = static_cast<NodeId>(reverse ? it->getStartId() : it->getEndId());
+        NodeId a = cursor[u]++;
+        heads[a] = v;
+        lineIds[a] = static_cast<NodeId>(it.slot());
+
+        NodeId b = a;
+        if (!it->isDirected()) {
+            b = cursor[v]++;
+            heads[b] = u;
+            lineIds[b] = static_cast<NodeId>(it.slot());
+        }
+
+        // Both arcs of a line share its weight in every profile column
+        for (size_t p = 0; p < profiles; p++) {
+            double weight = p == 0 ? it->getWeight() : weightProfiles->get(lines, p, it.slot());
+            weights[p * arcs + a] = weights[p * arcs + b] = convertWeight<Weight>(weight, weightScale);
+        }
+    }
+}
+
+template <typename NodeId, typename Weight>
+Graph<NodeId, Weight>::Graph(const PointStore& points, const LineStore& lines, double weightScale,
+    const WeightProfiles* weightProfiles)
+    : profiles(weightProfiles ? weightProfiles->count() : 1)
+{
+    buildArcs(points.capacity(), lines, weightProfiles, weightScale, false, offsets, targets, weights, lineIds);
+
+    // The reverse CSR differs only when some line is one-way
+    for (const Line& line : lines) {
+        if (line.isDirected()) {
+            symmetric = false;
+            break;
+        }
+    }
+    if (!symmetric) {
+        buildArcs(points.capacity(), lines, weightProfiles, weightScale, true, reverseOffsets, sources, reverseWeights, reverseLineIds);
+    }
+}
+
+vector<EdgeRecord> edgeRecords(const LineStore& lines, const WeightProfiles* profiles, size_t profile)
+{
+    vector<EdgeRecord> edges;
+    edges.reserve(lines.size());
+    for (auto it = lines.begin(); it != lines.end(); ++it) {
+        double weight = profiles ? profiles->get(lines, profile, it.slot()) : it->getWeight();
+        edges.push_back({ it->getStartId(), it->getEndId(), weight, it.slot(), it->isDirected() });
+    }
+    return edges;
+}
+
+template <typename NodeId, typename Weight>
+void Graph<NodeId, Weight>::buildSortedArcs(size_t nodes, const vector<EdgeRecord>& edges, double weightScale, bool reverse,
+    unsigned threads, vector<NodeId>& offsets, vector<NodeId>& heads, vector<Weight>& weights, vector<NodeId>& lineIds)
+{
+    struct Entry {
+        NodeId head;
+        Weight weight;
+        NodeId lineId;
+    };
+
+    // Degree of every node, counted by all chunks into one atomic array
+    vector<atomic<NodeId>> cursor(nodes);
+    parallelChunks(nodes, threads, [&](unsigned, size_t begin, size_t end) {
+        for (size_t u = begin; u < end; u++) cursor[u].store(0, memory_order_relaxed);
+    });
+    parallelChunks(edges.size(), threads, [&](unsigned, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            const EdgeRecord& e = edges[i];
+            cursor[reverse ? e.end : e.start].fetch_add(1, memory_order_relaxed);
+            if (!e.directed) cursor[reverse ? e.start : e.end].fetch_add(1, memory_order_relaxed);
+        }
+    });
+
+    // Node offsets; every cursor then points at the start of its node's list
+    offsets.assign(nodes + 1, 0);
+    parallelChunks(nodes, threads, [&](unsigned, size_t begin, size_t end) {
+        for (size_t u = begin; u < end; u++) offsets[u + 1] = cursor[u].load(memory_order_relaxed);
+    });
+    parallelPrefixSum(offsets, threads);
+    parallelChunks(nodes, threads, [&](unsigned, size_t begin, size_t end) {
+        for (size_t u = begin; u < end; u++) cursor[u].store(offsets[u], memory_order_relaxed);
+    });
+
+    // Scatter: the arcs of a list arrive in any order, the sort below fixes it
+    vector<Entry> entries(offsets.back());
+    parallelChunks(edges.size(), threads, [&](unsigned, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            const EdgeRecord& e = edges[i];
+            NodeId u = static_cast<NodeId>(reverse ? e.end : e.start);
+            NodeId v = static_cast<NodeId>(reverse ? e.start : e.end);
+            Weight w = convertWeight<Weight>(e.weight, weightScale);
+            NodeId lineId = static_cast<NodeId>(e.lineId);
+
+            entries[cursor[u].fetch_add(1, memory_order_relaxed)] = { v, w, lineId };
+            if (!e.directed) entries[cursor[v].fetch_add(1, memory_order_relaxed)] = { u, w, lineId };
+        }
+    });
+    vector<atomic<NodeId>>().swap(cursor);
+
+    // Sort every list by target and keep the lightest arc per target
+    vector<NodeId> keptOffsets(nodes + 1, 0);
+    parallelChunks(nodes, threads, [&](unsigned, size_t begin, size_t end) {
+        for (size_t u = begin; u < end; u++) {
+            auto first = entries.begin() + offsets[u];
+            auto last = entries.begin() + offsets[u + 1];
+            sort(first, last, [](const Entry& a, const Entry& b) {
+                if (a.head != b.head) return a.head < b.head;
+                if (a.weight != b.weight) return a.weight < b.weight;
+                return a.lineId < b.lineId;
+            });
+
+            auto out = first;
+            for (auto it = first; it != last; ++it) {
+                if (out != first && (out - 1)->head == it->head) continue;
+                *out++ = *it;
+            }
+            keptOffsets[u + 1] = static_cast<NodeId>(out - first);
+        }
+    });
+    parallelPrefixSum(keptOffsets, threads);
+
+    // Copy the kept arcs into the CSR arrays
+    heads.resize(keptOffsets.back());
+    weights.resize(keptOffsets.back());
+    lineIds.resize(keptOffsets.back());
+    parallelChunks(nodes, threads, [&](unsigned, size_t begin, size_t end) {
+        for (size_t u = begin; u < end; u++) {
+            NodeId from = offsets[u];
+            for (NodeId arc = keptOffsets[u]; arc < keptOffsets[u + 1]; arc++, from++) {
+                heads[arc] = entries[from].head;
+                weights[arc] = entries[from].weight;
+                lineIds[arc] = entries[from].lineId;
+            }
+        }
+    });
+    offsets.swap(keptOffsets);
+}
+
+template <typename NodeId, typename Weight>
+Graph<NodeId, Weight>::Graph(size_t nodes, const vector<EdgeRecord>& edges, double weightScale, unsigned threads)
+{
+    if (threads == 0) threads = workerCount(edges.size());
+    buildSortedArcs(nodes, edges, weightScale, false, threads, offsets, targets, weights, lineIds);
+
+    symmetric = none_of(edges.begin(), edges.end(), [](const EdgeRecord& e) { return e.directed; });
+    if (!symmetric) {
+        buildSortedArcs(nodes, edges, weightScale, true, threads, reverseOffsets, sources, reverseWeights, reverseLineIds);
+    }
+}
+
+template <typename NodeId, typename Weight>
+void Graph<NodeId, Weight>::permuteArcs(const vector<uint32_t>& newId, const vector<uint32_t>& oldId, size_t profiles,
+    const vector<NodeId>& offsets, const vector<NodeId>& heads, const vector<Weight>& weights, const vector<NodeId>& lineIds,
+    vector<NodeId>& newOffsets, vector<NodeId>& newHeads, vector<Weight>& newWeights, vector<NodeId>& newLineIds)
+{
+    size_t n = oldId.size();
+    size_t arcs = heads.size();
+    newOffsets.assign(n + 1, 0);
+    newHeads.resize(heads.size());
+    newWeights.resize(weights.size());
+    newLineIds.resize(lineIds.size());
+
+    // Lay out the arc lists in the new node order
+    NodeId next = 0;
+    for (size_t nu = 0; nu < n; nu++) {
+        NodeId u = static_cast<NodeId>(oldId[nu]);
+        newOffsets[nu] = next;
+        for (NodeId arc = offsets[u]; arc < offsets[u + 1]; arc++, next++) {
+            newHeads[next] = static_cast<NodeId>(newId[heads[arc]]);
+            newLineIds[next] = lineIds[arc];
+            for (size_t p = 0; p < profiles; p++) newWeights[p * arcs + next] = weights[p * arcs + arc];
+        }
+    }
+    newOffsets[n] = next;
+}
+
+template <typename NodeId, typename Weight>
+Graph<NodeId, Weight> Graph<NodeId, Weight>::permuted(const vector<uint32_t>& newId) const
+{
+    size_t n = nodeCount();
+    vector<uint32_t> oldId(n);
+    for (size_t u = 0; u < n; u++) oldId[newId[u]] = static_cast<uint32_t>(u);
+
+    Graph result;
+    result.profiles = profiles;
+    permuteArcs(newId, oldId, profiles, offsets, targets, weights, lineIds,
+        result.offsets, result.targets, result.weights, result.lineIds);
+
+    result.symmetric = symmetric;
+    if (!symmetric) {
+        permuteArcs(newId, oldId, profiles, reverseOffsets, sources, reverseWeights, reverseLineIds,
+            result.reverseOffsets, result.sources, result.reverseWeights, result.reverseLineIds);
+    }
+    return result;
+}
+
+template class Graph<size_t, double>;
+template class Graph<uint32_t, float>;
+template class Graph<uint32_t, uint32_t>;
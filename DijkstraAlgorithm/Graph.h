@@ -0,0 +1,246 @@
+#pragma once
+
+#ifndef GRAPH_H
+#define GRAPH_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "Point.h"
+#include "PointStore.h"
+#include "Line.h"
+#include "WeightProfiles.h"
+
+using namespace std;
+
+// ------------------------------------------------------------
+// Raw edge as read from a lines file, input of the parallel
+// CSR builder. Parallel edges and duplicates are allowed.
+// ------------------------------------------------------------
+struct EdgeRecord {
+    uint32_t start;
+    uint32_t end;
+    double weight;
+    uint32_t lineId;    // Line the arcs report back (e.g. the record index)
+    bool directed;      // One-way from start to end
+};
+
+// Edge records of all stored lines (line id = slot id), weighted by the
+// given profile (the lines' own weights without profiles)
+vector<EdgeRecord> edgeRecords(const LineStore& lines, const WeightProfiles* profiles = nullptr, size_t profile = 0);
+
+// ------------------------------------------------------------
+// Compressed-sparse-row (CSR) adjacency of the graph, parameterized
+// on the node id and weight types.
+// Neighbours of node u are the arcs in [begin(u), end(u)).
+// Every undirected Line produces two arcs (start->end, end->start),
+// a directed Line only start->end.
+// The reverse CSR (arcs grouped by head node, for backward searches)
+// is built in the same pass. Without directed lines it equals the
+// forward one, so it is not stored and the reverse accessors read
+// the forward arrays.
+// With weight profiles every profile gets its own weight column
+// (profile-major: all arcs of profile 0, then of profile 1, ...)
+// next to one shared copy of offsets, targets and line ids.
+// Built either from the stores (arcs in line order, one weight
+// column per profile) or from raw edge records by the parallel
+// builder (sorted neighbour lists, duplicates collapsed).
+// Node ids are point slot ids; free slots simply have no arcs.
+// Arc offsets use NodeId as well, so a 32-bit graph holds < 2^32 arcs.
+//
+// Explicit instantiations (Graph.cpp):
+//  - Graph<size_t, double>      default, exact weights
+//  - Graph<uint32_t, float>     half the memory per arc and heap entry
+//  - Graph<uint32_t, uint32_t>  integer weights (scaled and rounded)
+// ------------------------------------------------------------
+template <typename NodeId, typename Weight>
+class Graph
+{
+private:
+    vector<NodeId> offsets;  // First arc of each node, size = nodes + 1
+    vector<NodeId> targets;  // Neighbour node id of each arc
+    vector<Weight> weights;  // Weight of each arc, one column per profile
+    vector<NodeId> lineIds;  // Id of the Line each arc came from (for visualization)
+
+    // Reverse CSR: arcs into each node, with the tail node as "source"
+    vector<NodeId> reverseOffsets;
+    vector<NodeId> sources;
+    vector<Weight> reverseWeights;
+    vector<NodeId> reverseLineIds;
+    bool symmetric = true;   // No directed lines: the reverse CSR is the forward one
+    size_t profiles = 1;     // Number of weight columns
+
+    // Fills one direction of the CSR (reverse = arcs grouped by head node)
+    static void buildArcs(size_t nodes, const LineStore& lines, const WeightProfiles* weightProfiles, double weightScale, bool reverse,
+        vector<NodeId>& offsets, vector<NodeId>& heads, vector<Weight>& weights, vector<NodeId>& lineIds);
+
+    // Parallel builder of one direction of the CSR from edge records:
+    // degree count, prefix sum, scatter, per-node sort and collapse
+    static void buildSortedArcs(size_t nodes, const vector<EdgeRecord>& edges, double weightScale, bool reverse, unsigned threads,
+        vector<NodeId>& offsets, vector<NodeId>& heads, vector<Weight>& weights, vector<NodeId>& lineIds);
+
+    // Lays out one direction of the CSR in a new node order
+    static void permuteArcs(const vector<uint32_t>& newId, const vector<uint32_t>& oldId, size_t profiles,
+        const vector<NodeId>& offsets, const vector<NodeId>& heads, const vector<Weight>& weights, const vector<NodeId>& lineIds,
+        vector<NodeId>& newOffsets, vector<NodeId>& newHeads, vector<Weight>& newWeights, vector<NodeId>& newLineIds);
+
+public:
+    typedef NodeId NodeType;
+    typedef Weight WeightType;
+
+    // Empty adjacency without nodes
+    Graph() : offsets(1, 0) {}
+
+    // Builds the adjacency from points and the lines that reference them.
+    // Line weights are multiplied by weightScale (and rounded for integer weights).
+    // With weightProfiles every profile gets a weight column, otherwise only the Line weight.
+    Graph(const PointStore& points, const LineStore& lines, double weightScale = 1.0,
+        const WeightProfiles* weightProfiles = nullptr);
+
+    // Builds the adjacency of 'nodes' nodes from raw edges using all cores
+    // (threads = 0) or the given number of threads. Neighbour lists are
+    // sorted by target and parallel edges collapse to the lightest one.
+    Graph(size_t nodes, const vector<EdgeRecord>& edges, double weightScale = 1.0, unsigned threads = 0);
+
+    size_t nodeCount() const { return offsets.size() - 1; }
+    size_t arcCount() const { return targets.size(); }
+    size_t profileCount() const { return profiles; }
+
+    // Arc range of node u
+    NodeId begin(NodeId u) const { return offsets[u]; }
+    NodeId end(NodeId u) const { return offsets[u + 1]; }
+
+    // Arc data
+    NodeId target(NodeId arc) const { return targets[arc]; }
+    Weight weight(NodeId arc, size_t profile = 0) const { return weights[profile * targets.size() + arc]; }
+    NodeId lineId(NodeId arc) const { return lineIds[arc]; }
+
+    // Calls f(target, weight, lineId) for every arc of node u
+    template <typename F>
+    void forEachArc(NodeId u, F&& f) const {
+        for (NodeId arc = offsets[u]; arc < offsets[u + 1]; arc++) {
+            f(targets[arc], weights[arc], lineIds[arc]);
+        }
+    }
+
+    // Same, with the weights of the given profile
+    template <typename F>
+    void forEachArc(NodeId u, size_t profile, F&& f) const {
+        const Weight* column = weights.data() + profile * targets.size();
+        for (NodeId arc = offsets[u]; arc < offsets[u + 1]; arc++) {
+            f(targets[arc], column[arc], lineIds[arc]);
+        }
+    }
+
+    // True if the graph has no directed lines (reverse arcs = forward arcs)
+    bool isSymmetric() const { return symmetric; }
+    size_t reverseArcCount() const { return symmetric ? targets.size() : sources.size(); }
+
+    // Reverse arc range of node u (arcs ending in u) and reverse arc data
+    NodeId reverseBegin(NodeId u) const { return symmetric ? offsets[u] : reverseOffsets[u]; }
+    NodeId reverseEnd(NodeId u) const { return symmetric ? offsets[u + 1] : reverseOffsets[u + 1]; }
+    NodeId source(NodeId arc) const { return symmetric ? targets[arc] : sources[arc]; }
+    Weight reverseWeight(NodeId arc, size_t profile = 0) const {
+        return symmetric ? weight(arc, profile) : reverseWeights[profile * sources.size() + arc];
+    }
+    NodeId reverseLineId(NodeId arc) const { return symmetric ? lineIds[arc] : reverseLineIds[arc]; }
+
+    // Calls f(source, weight, lineId) for every arc ending in node u
+    template <typename F>
+    void forEachReverseArc(NodeId u, F&& f) const {
+        if (symmetric) {
+            forEachArc(u, f);
+            return;
+        }
+        for (NodeId arc = reverseOffsets[u]; arc < reverseOffsets[u + 1]; arc++) {
+            f(sources[arc], reverseWeights[arc], reverseLineIds[arc]);
+        }
+    }
+
+    // Same, with the weights of the given profile
+    template <typename F>
+    void forEachReverseArc(NodeId u, size_t profile, F&& f) const {
+        if (symmetric) {
+            forEachArc(u, profile, f);
+            return;
+        }
+        const Weight* column = reverseWeights.data() + profile * sources.size();
+        for (NodeId arc = reverseOffsets[u]; arc < reverseOffsets[u + 1]; arc++) {
+            f(sources[arc], column[arc], reverseLineIds[arc]);
+        }
+    }
+
+    // Copy of the graph with node u renumbered to newId[u] (arcs keep their line ids)
+    Graph permuted(const vector<uint32_t>& newId) const;
+
+    // Bytes used by the adjacency arrays
+    size_t memoryUsage() const {
+        return (offsets.size() + targets.size() + lineIds.size() + reverseOffsets.size() + sources.size() + reverseLineIds.size()) * sizeof(NodeId)
+            + (weights.size() + reverseWeights.size()) * sizeof(Weight);
+    }
+};
+
+// ------------------------------------------------------------
+// Backward view of a graph: forEachArc walks the reverse CSR, so
+// searches towards a target (many-to-one, the backward half of a
+// bidirectional search) run on the same code and at the same speed
+// as forward ones.
+// ------------------------------------------------------------
+template <typename GraphType>
+class ReverseGraph
+{
+private:
+    const GraphType& graph;
+
+public:
+    typedef typename GraphType::NodeType NodeType;
+    typedef typename GraphType::WeightType WeightType;
+
+    explicit ReverseGraph(const GraphType& graph) : graph(graph) {}
+
+    size_t nodeCount() const { return graph.nodeCount(); }
+    size_t arcCount() const { return graph.arcCount(); }
+
+    // Calls f(source, weight, lineId) for every arc ending in node u
+    template <typename F>
+    void forEachArc(NodeType u, F&& f) const { graph.forEachReverseArc(u, f); }
+};
+
+// ------------------------------------------------------------
+// View of a graph that runs on one of its weight profiles, so a
+// query selects the metric without copying the topology.
+// ------------------------------------------------------------
+template <typename GraphType>
+class ProfileGraph
+{
+private:
+    const GraphType& graph;
+    size_t profile;
+
+public:
+    typedef typename GraphType::NodeType NodeType;
+    typedef typename GraphType::WeightType WeightType;
+
+    ProfileGraph(const GraphType& graph, size_t profile) : graph(graph), profile(profile) {}
+
+    size_t nodeCount() const { return graph.nodeCount(); }
+    size_t arcCount() const { return graph.arcCount(); }
+    bool isSymmetric() const { return graph.isSymmetric(); }
+
+    // Calls f(target, weight, lineId) for every arc of node u
+    template <typename F>
+    void forEachArc(NodeType u, F&& f) const { graph.forEachArc(u, profile, f); }
+
+    // Calls f(source, weight, lineId) for every arc ending in node u
+    template <typename F>
+    void forEachReverseArc(NodeType u, F&& f) const { graph.forEachReverseArc(u, profile, f); }
+};
+
+extern template class Graph<size_t, double>;
+extern template class Graph<uint32_t, float>;
+extern template class Graph<uint32_t, uint32_t>;
+
+// Default adjacency used by the interactive graph
+typedef Graph<size_t, double> AdjacencyGraph;
+
+#endif
@@ -0,0 +1,55 @@
+#pragma once
+
+#ifndef GRAPHARENA_H
+#define GRAPHARENA_H
+
+#include <memory_resource>
+#include <string_view>
+#include <cstring>
+#include <cstddef>
+
+using namespace std;
+
+// Smallest arena block; larger blocks come from sizing hints
+#define ARENA_MIN_BYTES 4096
+
+// ------------------------------------------------------------
+// Memory arena for node-based graph containers (hash indexes,
+// per-node arc lists). A pool on top of a monotonic buffer:
+//  - allocations are carved from a few large upstream blocks,
+//    the first one sized by the caller (e.g. from a file pre-scan),
+//  - blocks freed by edits are recycled by the pool,
+//  - destroying the arena returns all blocks in one go, instead of
+//    freeing every node separately.
+// Containers using the arena must be destroyed before it.
+// ------------------------------------------------------------
+class GraphArena
+{
+private:
+    pmr::monotonic_buffer_resource buffer;
+    pmr::unsynchronized_pool_resource pool;
+
+public:
+    explicit GraphArena(size_t initialBytes = ARENA_MIN_BYTES)
+        : buffer(initialBytes > ARENA_MIN_BYTES ? initialBytes : ARENA_MIN_BYTES), pool(&buffer) {}
+
+    GraphArena(const GraphArena&) = delete;
+    GraphArena& operator=(const GraphArena&) = delete;
+
+    pmr::memory_resource* resource() { return &pool; }
+
+    // Copies the characters into the arena; the view lives until release or arena destruction
+    string_view storeString(string_view s) {
+        if (s.empty()) return string_view();
+        char* chars = static_cast<char*>(pool.allocate(s.size(), 1));
+        memcpy(chars, s.data(), s.size());
+        return string_view(chars, s.size());
+    }
+
+    // Returns the characters of a stored string to the pool
+    void releaseString(string_view s) {
+        if (!s.empty()) pool.deallocate(const_cast<char*>(s.data()), s.size(), 1);
+    }
+};
+
+#endif
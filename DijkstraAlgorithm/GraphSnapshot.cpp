@@ -0,0 +1,184 @@
+#include "GraphSnapshot.h"
+#include <fstream>
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+
+using namespace std;
+
+// Writes one array at its section offset, padding with zeros up to it
+template <typename T>
+static void writeSection(ofstream& out, uint64_t offset, const vector<T>& values)
+{
+    static const char zeros[SNAPSHOT_ALIGNMENT] = {};
+    uint64_t position = static_cast<uint64_t>(out.tellp());
+    out.write(zeros, static_cast<streamsize>(offset - position));
+    out.write(reinterpret_cast<const char*>(values.data()), static_cast<streamsize>(values.size() * sizeof(T)));
+}
+
+// ----------------------------------------------
+// Save points and lines as a snapshot image
+// Returns true if the whole file was written
+// ----------------------------------------------
+bool saveGraphSnapshot(const string& filename, const GraphStorage& graph)
+{
+    const PointStore& points = graph.getPoints();
+    const LineStore& lines = graph.getLines();
+
+    // Dense renumbering of the occupied point slots
+    vector<uint32_t> denseId(points.capacity(), INVALID_POINT_ID);
+    vector<double> xs, ys;
+    vector<uint64_t> nameOffsets(1, 0);
+    vector<char> names;
+
+    for (auto it = points.begin(); it != points.end(); ++it) {
+        denseId[it.slot()] = static_cast<uint32_t>(xs.size());
+        xs.push_back(it->getX());
+        ys.push_back(it->getY());
+        string_view name = it->getName();
+        names.insert(names.end(), name.begin(), name.end());
+        nameOffsets.push_back(names.size());
+    }
+    size_t nodeCount = xs.size();
+
+    auto nameOf = [&](uint32_t id) {
+        return string_view(names.data() + nameOffsets[id], nameOffsets[id + 1] - nameOffsets[id]);
+    };
+    vector<uint32_t> nameOrder(nodeCount);
+    for (uint32_t i = 0; i < nodeCount; i++) nameOrder[i] = i;
+    sort(nameOrder.begin(), nameOrder.end(), [&](uint32_t a, uint32_t b) { return nameOf(a) < nameOf(b); });
+
+    // CSR adjacency, two arcs per undirected line, one per directed line
+    vector<uint64_t> arcOffsets(nodeCount + 1, 0);
+    for (const Line& line : lines) {
+        arcOffsets[denseId[line.getStartId()] + 1]++;
+        if (!line.isDirected()) arcOffsets[denseId[line.getEndId()] + 1]++;
+    }
+    for (size_t i = 0; i < nodeCount; i++) arcOffsets[i + 1] += arcOffsets[i];
+
+    vector<uint32_t> targets(arcOffsets[nodeCount]);
+    vector<double> weights(arcOffsets[nodeCount]);
+    vector<uint64_t> next(arcOffsets.begin(), arcOffsets.end() - 1);
+    for (const Line& line : lines) {
+        uint32_t s = denseId[line.getStartId()];
+        uint32_t e = denseId[line.getEndId()];
+        targets[next[s]] = e; weights[next[s]++] = line.getWeight();
+        if (line.isDirected()) continue;
+        targets[next[e]] = s; weights[next[e]++] = line.getWeight();
+    }
+
+    // Header with aligned section offsets
+    SnapshotHeader header = {};
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.headerSize = sizeof(SnapshotHeader);
+    header.nodeCount = nodeCount;
+    header.arcCount = targets.size();
+    header.nameBytes = names.size();
+
+    header.xsOffset = alignOffset(sizeof(SnapshotHeader), SNAPSHOT_ALIGNMENT);
+    header.ysOffset = alignOffset(header.xsOffset + xs.size() * sizeof(double), SNAPSHOT_ALIGNMENT);
+    header.nameOffsetsOffset = alignOffset(header.ysOffset + ys.size() * sizeof(double), SNAPSHOT_ALIGNMENT);
+    header.namesOffset = alignOffset(header.nameOffsetsOffset + nameOffsets.size() * sizeof(uint64_t), SNAPSHOT_ALIGNMENT);
+    header.nameOrderOffset = alignOffset(header.namesOffset + names.size(), SNAPSHOT_ALIGNMENT);
+    header.arcOffsetsOffset = alignOffset(header.nameOrderOffset + nameOrder.size() * sizeof(uint32_t), SNAPSHOT_ALIGNMENT);
+    header.targetsOffset = alignOffset(header.arcOffsetsOffset + arcOffsets.size() * sizeof(uint64_t), SNAPSHOT_ALIGNMENT);
+    header.weightsOffset = alignOffset(header.targetsOffset + targets.size() * sizeof(uint32_t), SNAPSHOT_ALIGNMENT);
+    header.fileSize = header.weightsOffset + weights.size() * sizeof(double);
+
+    ofstream out(filename, ios::binary | ios::trunc);
+    if (!out.is_open()) {
+        cout << "Snapshot Error: Cannot create file (" << filename << ")" << endl;
+        return false;
+    }
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    writeSection(out, header.xsOffset, xs);
+    writeSection(out, header.ysOffset, ys);
+    writeSection(out, header.nameOffsetsOffset, nameOffsets);
+    writeSection(out, header.namesOffset, names);
+    writeSection(out, header.nameOrderOffset, nameOrder);
+    writeSection(out, header.arcOffsetsOffset, arcOffsets);
+    writeSection(out, header.targetsOffset, targets);
+    writeSection(out, header.weightsOffset, weights);
+
+    if (!out.good()) {
+        cout << "Snapshot Error: Write failed (" << filename << ")" << endl;
+        return false;
+    }
+    return true;
+}
+
+// ----------------------------------------------
+// Map a snapshot read-only
+// ----------------------------------------------
+bool GraphSnapshot::open(const string& filename)
+{
+    close();
+    if (!file.open(filename)) return false;
+
+    if (!validate()) {
+        cout << "Snapshot Error: Invalid or incompatible file (" << filename << ")" << endl;
+        close();
+        return false;
+    }
+    return true;
+}
+
+void GraphSnapshot::close()
+{
+    file.close();
+    header = nullptr;
+}
+
+// Checks the header against the mapped size and points the arrays into the mapping
+bool GraphSnapshot::validate()
+{
+    const uint8_t* data = file.data();
+    size_t size = file.size();
+    if (size < sizeof(SnapshotHeader)) return false;
+    header = reinterpret_cast<const SnapshotHeader*>(data);
+
+    if (memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(header->magic)) != 0) return false;
+    if (header->version != SNAPSHOT_VERSION || header->headerSize != sizeof(SnapshotHeader)) return false;
+    if (header->fileSize != size || header->nodeCount >= INVALID_POINT_ID) return false;
+
+    uint64_t n = header->nodeCount;
+    uint64_t m = header->arcCount;
+
+    // Every section must be aligned and lie inside the file
+    auto fits = [&](uint64_t offset, uint64_t bytes) { return sectionFits(offset, bytes, size, SNAPSHOT_ALIGNMENT); };
+    if (!fits(header->xsOffset, n * sizeof(double)) ||
+        !fits(header->ysOffset, n * sizeof(double)) ||
+        !fits(header->nameOffsetsOffset, (n + 1) * sizeof(uint64_t)) ||
+        !fits(header->namesOffset, header->nameBytes) ||
+        !fits(header->nameOrderOffset, n * sizeof(uint32_t)) ||
+        !fits(header->arcOffsetsOffset, (n + 1) * sizeof(uint64_t)) ||
+        !fits(header->targetsOffset, m * sizeof(uint32_t)) ||
+        !fits(header->weightsOffset, m * sizeof(double))) return false;
+
+    xs = reinterpret_cast<const double*>(data + header->xsOffset);
+    ys = reinterpret_cast<const double*>(data + header->ysOffset);
+    nameOffsets = reinterpret_cast<const uint64_t*>(data + header->nameOffsetsOffset);
+    names = reinterpret_cast<const char*>(data + header->namesOffset);
+    nameOrder = reinterpret_cast<const uint32_t*>(data + header->nameOrderOffset);
+    arcOffsets = reinterpret_cast<const uint64_t*>(data + header->arcOffsetsOffset);
+    targets = reinterpret_cast<const uint32_t*>(data + header->targetsOffset);
+    weights = reinterpret_cast<const double*>(data + header->weightsOffset);
+
+    // Only the O(1) boundary entries are checked, the arrays stay untouched
+    return nameOffsets[n] == header->nameBytes && arcOffsets[n] == m;
+}
+
+uint32_t GraphSnapshot::findPoint(string_view name) const
+{
+    if (!isOpen()) return INVALID_POINT_ID;
+
+    const uint32_t* first = nameOrder;
+    const uint32_t* last = nameOrder + header->nodeCount;
+    const uint32_t* it = lower_bound(first, last, name,
+        [this](uint32_t id, string_view key) { return getName(id) < key; });
+
+    return (it != last && getName(*it) == name) ? *it : INVALID_POINT_ID;
+}
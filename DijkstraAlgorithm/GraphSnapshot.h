@@ -0,0 +1,117 @@
+#pragma once
+
+#ifndef GRAPHSNAPSHOT_H
+#define GRAPHSNAPSHOT_H
+
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <cstddef>
+#include "GraphStorage.h"
+#include "MappedFile.h"
+
+using namespace std;
+
+// ------------------------------------------------------------
+// Immutable binary graph image
+//
+// File layout (native endianness, every section 64-byte aligned):
+//   SnapshotHeader
+//   xs, ys          double[nodes]       coordinates
+//   nameOffsets     uint64[nodes + 1]   into the name table
+//   names           char[nameBytes]     names, not terminated
+//   nameOrder       uint32[nodes]       node ids sorted by name
+//   arcOffsets      uint64[nodes + 1]   CSR offsets
+//   targets         uint32[arcs]
+//   weights         double[arcs]
+//
+// Node ids are the occupied point slots renumbered densely.
+// Opening maps the file read-only and reads every array in place:
+// nothing is parsed or copied, and processes mapping the same
+// file share its pages.
+// ------------------------------------------------------------
+#define SNAPSHOT_MAGIC "DJKGRPH"
+#define SNAPSHOT_VERSION 1
+#define SNAPSHOT_ALIGNMENT 64
+
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    uint64_t nodeCount;
+    uint64_t arcCount;
+    uint64_t nameBytes;
+    uint64_t fileSize;
+
+    // Byte offsets of the sections from the start of the file
+    uint64_t xsOffset;
+    uint64_t ysOffset;
+    uint64_t nameOffsetsOffset;
+    uint64_t namesOffset;
+    uint64_t nameOrderOffset;
+    uint64_t arcOffsetsOffset;
+    uint64_t targetsOffset;
+    uint64_t weightsOffset;
+};
+
+// Writes the current points and lines as a snapshot file
+bool saveGraphSnapshot(const string& filename, const GraphStorage& graph);
+
+// ------------------------------------------------------------
+// Read-only view of a mapped snapshot, usable directly by
+// DijkstraQuery (line ids are reported as UINT32_MAX)
+// ------------------------------------------------------------
+class GraphSnapshot
+{
+private:
+    MappedFile file;
+
+    const SnapshotHeader* header = nullptr;
+    const double* xs = nullptr;
+    const double* ys = nullptr;
+    const uint64_t* nameOffsets = nullptr;
+    const char* names = nullptr;
+    const uint32_t* nameOrder = nullptr;
+    const uint64_t* arcOffsets = nullptr;
+    const uint32_t* targets = nullptr;
+    const double* weights = nullptr;
+
+    bool validate();
+
+public:
+    typedef uint32_t NodeType;
+    typedef double WeightType;
+
+    GraphSnapshot() = default;
+
+    GraphSnapshot(const GraphSnapshot&) = delete;
+    GraphSnapshot& operator=(const GraphSnapshot&) = delete;
+
+    // Maps the file; returns false (and stays closed) if it is missing or malformed
+    bool open(const string& filename);
+    void close();
+    bool isOpen() const { return header != nullptr; }
+
+    size_t nodeCount() const { return header ? header->nodeCount : 0; }
+    size_t arcCount() const { return header ? header->arcCount : 0; }
+    size_t mappedBytes() const { return file.size(); }
+
+    double getX(uint32_t id) const { return xs[id]; }
+    double getY(uint32_t id) const { return ys[id]; }
+    string_view getName(uint32_t id) const {
+        return string_view(names + nameOffsets[id], nameOffsets[id + 1] - nameOffsets[id]);
+    }
+
+    // Binary search in the name order; INVALID_POINT_ID if absent
+    uint32_t findPoint(string_view name) const;
+
+    // Calls f(target, weight, lineId) for every arc of node u
+    template <typename F>
+    void forEachArc(uint32_t u, F&& f) const {
+        for (uint64_t arc = arcOffsets[u]; arc < arcOffsets[u + 1]; arc++) {
+            f(targets[arc], weights[arc], UINT32_MAX);
+        }
+    }
+};
+
+#endif
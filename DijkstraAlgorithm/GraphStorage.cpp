@@ -0,0 +1,220 @@
+#include "GraphStorage.h"
+#include <algorithm>
+
+// Rough arena bytes per point (name and coordinate nodes plus name chars)
+// and per line (edge nodes of both directions), used to size the first arena block
+#define ARENA_BYTES_PER_POINT 128
+#define ARENA_BYTES_PER_LINE 96
+
+GraphStorage::GraphStorage()
+    : points(make_shared<PointStore>()), lines(make_shared<LineStore>()), adjacency(make_shared<DynamicAdjacency>()),
+      profiles(make_shared<WeightProfiles>()), index(make_unique<Indexes>(ARENA_MIN_BYTES))
+{
+    // Readers always find a version, even before the first edit
+    publish();
+}
+
+PointStore& GraphStorage::writablePoints()
+{
+    if (pointsShared) {
+        points = make_shared<PointStore>(*points);
+        pointsShared = false;
+    }
+    return *points;
+}
+
+LineStore& GraphStorage::writableLines()
+{
+    if (linesShared) {
+        lines = make_shared<LineStore>(*lines);
+        linesShared = false;
+    }
+    return *lines;
+}
+
+DynamicAdjacency& GraphStorage::writableAdjacency()
+{
+    if (adjacencyShared) {
+        adjacency = make_shared<DynamicAdjacency>(*adjacency);
+        adjacencyShared = false;
+    }
+    return *adjacency;
+}
+
+WeightProfiles& GraphStorage::writableProfiles()
+{
+    if (profilesShared) {
+        profiles = make_shared<WeightProfiles>(*profiles);
+        profilesShared = false;
+    }
+    return *profiles;
+}
+
+void GraphStorage::publish()
+{
+    auto version = make_shared<const GraphVersion>(points, lines, adjacency, profiles, ++versionCount);
+    pointsShared = linesShared = adjacencyShared = profilesShared = true;
+    atomic_store(&published, shared_ptr<const GraphVersion>(move(version)));
+}
+
+void GraphStorage::eraseLine(uint32_t lineId)
+{
+    const Line& l = getLines()[lineId];
+    uint32_t start = l.getStartId(), end = l.getEndId();
+
+    writableAdjacency().removeLine(lineId, start, end);
+    unindexLine(start, end, lineId);
+    if (!l.isDirected()) unindexLine(end, start, lineId);
+    LineStore& store = writableLines();
+    store.erase(store.handleAt(lineId));
+}
+
+uint64_t GraphStorage::edgeKey(uint32_t a, uint32_t b)
+{
+    return (static_cast<uint64_t>(a) << 32) | b;
+}
+
+void GraphStorage::unindexLine(uint32_t a, uint32_t b, uint32_t lineId)
+{
+    auto it = index->edges.find(edgeKey(a, b));
+    if (it != index->edges.end() && it->second == lineId) index->edges.erase(it);
+}
+
+uint32_t GraphStorage::findPoint(string_view name) const
+{
+    auto it = index->names.find(name);
+    return it == index->names.end() ? INVALID_POINT_ID : it->second;
+}
+
+bool GraphStorage::hasPointAt(double x, double y) const
+{
+    return index->coordinates.count({ x, y }) > 0;
+}
+
+uint32_t GraphStorage::findDirectedLine(uint32_t a, uint32_t b) const
+{
+    auto it = index->edges.find(edgeKey(a, b));
+    return it == index->edges.end() ? INVALID_LINE_ID : it->second;
+}
+
+uint32_t GraphStorage::findLine(uint32_t a, uint32_t b) const
+{
+    uint32_t lineId = findDirectedLine(a, b);
+    return lineId != INVALID_LINE_ID ? lineId : findDirectedLine(b, a);
+}
+
+uint32_t GraphStorage::addPoint(const Point& p)
+{
+    uint32_t id = writablePoints().insert(p).index;
+
+    writableAdjacency().addNode(id);
+    auto it = index->names.find(string_view(p.getName()));
+    if (it != index->names.end()) it->second = id;
+    else index->names.emplace(index->arena.storeString(p.getName()), id);
+    index->coordinates.insert({ p.getX(), p.getY() });
+    return id;
+}
+
+uint32_t GraphStorage::addLine(uint32_t start, uint32_t end, double weight, bool directed)
+{
+    LineHandle h = writableLines().insert(Line(points->handleAt(start), points->handleAt(end), weight, directed));
+    writableAdjacency().addLine(h.index, start, end, weight, directed);
+    if (profiles->count() > 1) writableProfiles().addLine(h.index, weight);
+    index->edges[edgeKey(start, end)] = h.index;
+    if (!directed) index->edges[edgeKey(end, start)] = h.index;
+    if (adjacency->needsCompaction()) compact();
+    return h.index;
+}
+
+void GraphStorage::setLineWeight(uint32_t lineId, size_t profile, double weight)
+{
+    writableProfiles().set(profile, lineId, weight);
+}
+
+void GraphStorage::setProfiles(vector<string> names)
+{
+    writableProfiles().setNames(move(names));
+}
+
+bool GraphStorage::removePoint(uint32_t id)
+{
+    if (!points->isOccupied(id)) return false;
+
+    // Remove all lines that touch this point (outgoing and incoming)
+    vector<uint32_t> touching;
+    auto collect = [&touching](uint32_t, double, uint32_t lineId) { touching.push_back(lineId); };
+    adjacency->forEachArc(id, collect);
+    adjacency->forEachReverseArc(id, collect);
+    sort(touching.begin(), touching.end());
+    touching.erase(unique(touching.begin(), touching.end()), touching.end());
+    for (uint32_t lineId : touching) eraseLine(lineId);
+
+    PointView p = getPoints()[id];
+    auto it = index->names.find(p.getName());
+    if (it != index->names.end() && it->second == id) {
+        string_view key = it->first;
+        index->names.erase(it);
+        index->arena.releaseString(key);
+    }
+    index->coordinates.erase({ p.getX(), p.getY() });
+
+    PointStore& store = writablePoints();
+    store.erase(store.handleAt(id));
+    if (adjacency->needsCompaction()) compact();
+    return true;
+}
+
+bool GraphStorage::removeLine(uint32_t a, uint32_t b)
+{
+    uint32_t lineId = findLine(a, b);
+    if (lineId == INVALID_LINE_ID) return false;
+
+    eraseLine(lineId);
+    if (adjacency->needsCompaction()) compact();
+    return true;
+}
+
+void GraphStorage::clearLines()
+{
+    // Fresh store: published versions keep the old one
+    lines = make_shared<LineStore>();
+    linesShared = false;
+    if (profiles->count() > 1) writableProfiles().clearLines();
+    index->edges.clear();
+    compact();
+}
+
+void GraphStorage::compact()
+{
+    writableAdjacency().compact(*points, *lines);
+}
+
+void GraphStorage::clear()
+{
+    // Fresh components: published versions keep the old ones
+    points = make_shared<PointStore>();
+    lines = make_shared<LineStore>();
+    adjacency = make_shared<DynamicAdjacency>();
+    profiles = make_shared<WeightProfiles>();
+    pointsShared = linesShared = adjacencyShared = profilesShared = false;
+
+    // Drop the old arena before creating the new one to keep the peak low
+    index.reset();
+    index = make_unique<Indexes>(ARENA_MIN_BYTES);
+}
+
+void GraphStorage::reserve(size_t pointCount, size_t lineCount)
+{
+    writablePoints().reserve(pointCount);
+    writableLines().reserve(lineCount);
+    writableAdjacency().reserve(pointCount);
+    if (profiles->count() > 1) writableProfiles().reserve(lines->capacity() + lineCount);
+
+    if (points->empty() && lines->empty()) {
+        index.reset();
+        index = make_unique<Indexes>(pointCount * ARENA_BYTES_PER_POINT + lineCount * ARENA_BYTES_PER_LINE);
+    }
+    index->names.reserve(points->size() + pointCount);
+    index->coordinates.reserve(points->size() + pointCount);
+    index->edges.reserve(2 * (lines->size() + lineCount));   // Two-way lines take both directions
+}
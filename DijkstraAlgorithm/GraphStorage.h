@@ -0,0 +1,179 @@
+#pragma once
+
+#ifndef GRAPHSTORAGE_H
+#define GRAPHSTORAGE_H
+
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <string_view>
+#include <memory>
+#include <memory_resource>
+#include <cstdint>
+#include "Point.h"
+#include "Line.h"
+#include "PointStore.h"
+#include "DynamicAdjacency.h"
+#include "GraphArena.h"
+#include "GraphVersion.h"
+#include "WeightProfiles.h"
+
+using namespace std;
+
+// Hash for (x, y) coordinate pairs used by the duplicate check
+struct CoordinateHash {
+    size_t operator()(const pair<double, double>& c) const {
+        size_t h = hash<double>()(c.first);
+        return h ^ (hash<double>()(c.second) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2));
+    }
+};
+
+// ------------------------------------------------------------
+// Owns the points and lines of the graph.
+// Points live column-wise in a PointStore and lines in a slot map;
+// both use generational slots: the id of a
+// point or line is its slot index, which never changes while the
+// element exists, and Lines refer to points by handle, so adding
+// or deleting points never invalidates other elements.
+// Names are interned in a hash map, so lookups by name happen once
+// at the console/file boundary and everything else works on ids.
+// The adjacency is updated with every edit and compacted periodically,
+// so queries never need a full rebuild.
+// The hash indexes allocate from one GraphArena: loading sizes it
+// from reserve() hints and clear() drops it as a whole.
+//
+// GraphStorage is the single writer (console thread). publish()
+// hands the current points, lines and adjacency to readers as an
+// immutable GraphVersion; the next edit of a published component
+// works on a private copy (copy-on-write), so published versions
+// never change. Components keep their data in shared chunks
+// (ChunkedColumn), so that copy takes only the chunk pointers and
+// an edit then copies just the chunks it writes.
+// The indexes are writer-only and never shared.
+// ------------------------------------------------------------
+class GraphStorage
+{
+private:
+    shared_ptr<PointStore> points;
+    shared_ptr<LineStore> lines;
+    shared_ptr<DynamicAdjacency> adjacency;     // Neighbours of every point, kept in sync with edits
+    shared_ptr<WeightProfiles> profiles;        // Named weight columns of the lines
+
+    // Set for components referenced by a published version; writing one first copies it
+    bool pointsShared = false;
+    bool linesShared = false;
+    bool adjacencyShared = false;
+    bool profilesShared = false;
+
+    shared_ptr<const GraphVersion> published;   // Latest version, accessed atomically
+    uint64_t versionCount = 0;                  // Number of versions published so far
+
+    // Lookup indexes and the arena their nodes and name keys live in
+    struct Indexes {
+        GraphArena arena;
+        pmr::unordered_map<uint64_t, uint32_t> edges;       // Ordered endpoint pair -> line usable in that direction
+        pmr::unordered_map<string_view, uint32_t> names;    // Point name (chars in the arena) -> point id
+        pmr::unordered_set<pair<double, double>, CoordinateHash> coordinates; // (x, y) of stored points
+
+        explicit Indexes(size_t arenaBytes)
+            : arena(arenaBytes), edges(arena.resource()), names(arena.resource()), coordinates(arena.resource()) {}
+    };
+    unique_ptr<Indexes> index;
+
+    // Write access to the components, copying them first if a version shares them
+    PointStore& writablePoints();
+    LineStore& writableLines();
+    DynamicAdjacency& writableAdjacency();
+    WeightProfiles& writableProfiles();
+
+    // Removes a line from the slot map and all indexes
+    void eraseLine(uint32_t lineId);
+
+    // Drops the edge index entry a -> b if it refers to lineId
+    void unindexLine(uint32_t a, uint32_t b, uint32_t lineId);
+
+    // Key of the direction a -> b in the edge index (two-way lines are
+    // stored under both directions, one-way lines under theirs only)
+    static uint64_t edgeKey(uint32_t a, uint32_t b);
+
+public:
+    GraphStorage();
+
+    GraphStorage(const GraphStorage&) = delete;
+    GraphStorage& operator=(const GraphStorage&) = delete;
+
+    // Read access for the writer thread (other threads use current())
+    const PointStore& getPoints() const { return *points; }
+    const LineStore& getLines() const { return *lines; }
+    const DynamicAdjacency& getAdjacency() const { return *adjacency; }
+    const WeightProfiles& getProfiles() const { return *profiles; }
+
+    // Write access for visual state (colors, start/end flags);
+    // copies the points first if a published version shares them
+    PointRef getPoint(uint32_t id) { return writablePoints()[id]; }
+    PointStore& editPoints() { return writablePoints(); }
+
+    // Makes the current state visible to readers as a new immutable version
+    void publish();
+
+    // Latest published version; safe to call from any thread
+    shared_ptr<const GraphVersion> current() const { return atomic_load(&published); }
+
+    // Returns the id of the point with the given name or INVALID_POINT_ID
+    uint32_t findPoint(string_view name) const;
+
+    // Checks whether some point already occupies the given coordinates
+    bool hasPointAt(double x, double y) const;
+
+    // Returns the id of the line usable from a to b (two-way, or one-way a -> b) or INVALID_LINE_ID, O(1).
+    // A pair of points holds one two-way line or up to one one-way line per direction.
+    uint32_t findDirectedLine(uint32_t a, uint32_t b) const;
+
+    // Returns the id of a line connecting two points, preferring the one usable from a to b,
+    // or INVALID_LINE_ID, O(1)
+    uint32_t findLine(uint32_t a, uint32_t b) const;
+
+    // Checks whether a line already connects the two points (either direction), O(1)
+    bool hasLine(uint32_t a, uint32_t b) const { return findLine(a, b) != INVALID_LINE_ID; }
+
+    // Checks whether a new line from a to b would duplicate an existing one: a one-way
+    // line conflicts with a two-way line or one in its direction, a two-way line with any
+    bool conflictsWithLine(uint32_t a, uint32_t b, bool directed) const {
+        return findDirectedLine(a, b) != INVALID_LINE_ID || (!directed && findDirectedLine(b, a) != INVALID_LINE_ID);
+    }
+
+    // Stores a copy of the point and returns its id (no validation)
+    uint32_t addPoint(const Point& p);
+
+    // Connects two stored points, one-way from start to end if directed (no validation).
+    // The weight is the primary profile and the default for all others. Returns the line id
+    uint32_t addLine(uint32_t start, uint32_t end, double weight, bool directed = false);
+
+    // Sets the weight of a line in an extra profile (profile >= 1, no validation)
+    void setLineWeight(uint32_t lineId, size_t profile, double weight);
+
+    // Replaces the weight profiles by the given names; call before adding lines
+    void setProfiles(vector<string> names);
+
+    // Removes a point with all lines that touch it, O(degree^2) worst case
+    bool removePoint(uint32_t id);
+
+    // Removes the line between two points (both directions), O(degree)
+    bool removeLine(uint32_t a, uint32_t b);
+
+    // Removes all lines, keeping points and profile names
+    void clearLines();
+
+    // Folds pending edits into the compact adjacency (e.g. after bulk loading)
+    void compact();
+
+    // Removes everything, releasing the index arena at once
+    void clear();
+
+    // Pre-sizes storage for a bulk load (e.g. from a file pre-scan).
+    // On an empty graph the index arena is recreated with a matching first block.
+    void reserve(size_t pointCount, size_t lineCount);
+};
+
+#endif
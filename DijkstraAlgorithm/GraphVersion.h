@@ -0,0 +1,84 @@
+#pragma once
+
+#ifndef GRAPHVERSION_H
+#define GRAPHVERSION_H
+
+#include <memory>
+#include <cstdint>
+#include "PointStore.h"
+#include "Line.h"
+#include "DynamicAdjacency.h"
+#include "WeightProfiles.h"
+
+using namespace std;
+
+// ------------------------------------------------------------
+// Immutable, reference-counted state of the graph at one point
+// in time. GraphStorage publishes a new version after each edit;
+// readers (renderer, queries) take the current one with an atomic
+// load and keep using it while edits continue, so neither side
+// waits for the other.
+// Versions share their components down to fixed-size chunks: an
+// edit copies only the chunks it touches (of points, lines, weight
+// profiles or adjacency delta), and the compact adjacency base is
+// shared by every version until it is rebuilt.
+// ------------------------------------------------------------
+class GraphVersion
+{
+private:
+    shared_ptr<const PointStore> points;
+    shared_ptr<const LineStore> lines;
+    shared_ptr<const DynamicAdjacency> adjacency;
+    shared_ptr<const WeightProfiles> profiles;
+    uint64_t number;    // Increases with every published version
+
+public:
+    GraphVersion(shared_ptr<const PointStore> points, shared_ptr<const LineStore> lines,
+        shared_ptr<const DynamicAdjacency> adjacency, shared_ptr<const WeightProfiles> profiles, uint64_t number)
+        : points(move(points)), lines(move(lines)), adjacency(move(adjacency)), profiles(move(profiles)), number(number) {}
+
+    const PointStore& getPoints() const { return *points; }
+    const LineStore& getLines() const { return *lines; }
+    const DynamicAdjacency& getAdjacency() const { return *adjacency; }
+    const WeightProfiles& getProfiles() const { return *profiles; }
+    uint64_t getNumber() const { return number; }
+};
+
+// ------------------------------------------------------------
+// One version in one weight profile as a query graph (the interface
+// of Graph / ProfileGraph), so the query classes run directly on the
+// live adjacency. The adjacency holds the primary weight; the other
+// profiles read their column per arc.
+// ------------------------------------------------------------
+class VersionGraph
+{
+private:
+    const GraphVersion& version;
+    size_t profile;
+
+public:
+    typedef uint32_t NodeType;
+    typedef double WeightType;
+
+    VersionGraph(const GraphVersion& version, size_t profile) : version(version), profile(profile) {}
+
+    size_t nodeCount() const { return version.getAdjacency().nodeCount(); }
+
+    // Calls f(target, weight, lineId) for every arc of node u
+    template <typename F>
+    void forEachArc(uint32_t u, F&& f) const {
+        version.getAdjacency().forEachArc(u, [&](uint32_t v, double weight, uint32_t lineId) {
+            f(v, profile == 0 ? weight : version.getProfiles().get(version.getLines(), profile, lineId), lineId);
+        });
+    }
+
+    // Calls f(source, weight, lineId) for every arc ending in node u
+    template <typename F>
+    void forEachReverseArc(uint32_t u, F&& f) const {
+        version.getAdjacency().forEachReverseArc(u, [&](uint32_t v, double weight, uint32_t lineId) {
+            f(v, profile == 0 ? weight : version.getProfiles().get(version.getLines(), profile, lineId), lineId);
+        });
+    }
+};
+
+#endif
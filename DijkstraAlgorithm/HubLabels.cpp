@@ -0,0 +1,351 @@
+#include "HubLabels.h"
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <numeric>
+#include <limits>
+#include <cstring>
+
+// Label entry while building
+struct LabelEntry {
+    uint32_t hub;
+    uint32_t parent;
+    uint32_t line;
+    double distance;
+};
+
+template <typename GraphType>
+bool HubLabels::build(const GraphType& graph, const ContractionHierarchy& hierarchy, uint64_t graphFingerprint)
+{
+    size_t n = graph.nodeCount();
+    if (hierarchy.nodeCount() != n) {
+        cout << "Hub Label Error: Hierarchy does not belong to this graph" << endl;
+        return false;
+    }
+    close();
+
+    // Hubs in contraction order, most important (contracted last) first
+    vector<uint32_t> order(n);
+    iota(order.begin(), order.end(), 0);
+    sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return hierarchy.getRank(a) > hierarchy.getRank(b); });
+
+    // Side 0 holds d(v, hub), side 1 d(hub, v); one side serves both on symmetric graphs
+    bool symmetric = graph.isSymmetric();
+    int sides = symmetric ? 1 : 2;
+    vector<vector<LabelEntry>> labels[2];
+    for (int side = 0; side < sides; side++) labels[side].resize(n);
+
+    const double unreached = numeric_limits<double>::infinity();
+    vector<double> hubDistance(n, unreached);   // Label of the current hub, by hub index
+    vector<double> dist(n, unreached);
+    vector<uint32_t> parent(n), parentLine(n), touched;
+    typedef pair<double, uint32_t> Entry;
+    vector<Entry> heap;
+    auto later = greater<Entry>();
+
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t h = order[i];
+        for (int side = 0; side < sides; side++) {
+            // d(v, h) needs the reverse search and is checked against h's backward label
+            bool reverse = side == 0 && !symmetric;
+            const vector<LabelEntry>& own = labels[symmetric ? 0 : 1 - side][h];
+            for (const LabelEntry& e : own) hubDistance[e.hub] = e.distance;
+
+            dist[h] = 0.0;
+            parent[h] = h;
+            parentLine[h] = UINT32_MAX;
+            touched.push_back(h);
+            heap.push_back({ 0.0, h });
+
+            while (!heap.empty()) {
+                pop_heap(heap.begin(), heap.end(), later);
+                auto [d, v] = heap.back();
+                heap.pop_back();
+                if (d > dist[v]) continue;  // Skip outdated values
+
+                // Pruned: an earlier hub already gives this distance
+                bool covered = false;
+                for (const LabelEntry& e : labels[side][v]) {
+                    if (hubDistance[e.hub] + e.distance <= d) {
+                        covered = true;
+                        break;
+                    }
+                }
+                if (covered) continue;
+                labels[side][v].push_back({ i, parent[v], parentLine[v], d });
+
+                auto relax = [&](auto u, auto weight, auto lineId) {
+                    double alt = d + static_cast<double>(weight);
+                    if (alt < dist[u]) {
+                        if (dist[u] == unreached) touched.push_back(static_cast<uint32_t>(u));
+                        dist[u] = alt;
+                        parent[u] = v;
+                        parentLine[u] = static_cast<uint32_t>(lineId);
+                        heap.push_back({ alt, static_cast<uint32_t>(u) });
+                        push_heap(heap.begin(), heap.end(), later);
+                    }
+                };
+                if (reverse) graph.forEachReverseArc(static_cast<typename GraphType::NodeType>(v), relax);
+                else graph.forEachArc(static_cast<typename GraphType::NodeType>(v), relax);
+            }
+
+            for (uint32_t v : touched) dist[v] = unreached;
+            touched.clear();
+            for (const LabelEntry& e : own) hubDistance[e.hub] = unreached;
+        }
+    }
+
+    // Section layout
+    HubLabelHeader layout = {};
+    memcpy(layout.magic, HUBLABEL_MAGIC, sizeof(HUBLABEL_MAGIC));
+    layout.version = HUBLABEL_VERSION;
+    layout.headerSize = sizeof(HubLabelHeader);
+    layout.nodeCount = n;
+    layout.fingerprint = graphFingerprint;
+    layout.symmetric = symmetric ? 1 : 0;
+
+    uint64_t offset = alignOffset(sizeof(HubLabelHeader), HUBLABEL_ALIGNMENT);
+    layout.hubNodesOffset = offset;
+    offset = alignOffset(offset + n * sizeof(uint32_t), HUBLABEL_ALIGNMENT);
+    for (int side = 0; side < sides; side++) {
+        uint64_t entries = n;
+        for (const auto& label : labels[side]) entries += label.size();
+        layout.entryCount[side] = entries;
+
+        layout.offsetsOffset[side] = offset;
+        offset = alignOffset(offset + (n + 1) * sizeof(uint64_t), HUBLABEL_ALIGNMENT);
+        layout.hubsOffset[side] = offset;
+        offset = alignOffset(offset + entries * sizeof(uint32_t), HUBLABEL_ALIGNMENT);
+        layout.distancesOffset[side] = offset;
+        offset = alignOffset(offset + entries * sizeof(double), HUBLABEL_ALIGNMENT);
+        layout.parentsOffset[side] = offset;
+        offset = alignOffset(offset + entries * sizeof(uint32_t), HUBLABEL_ALIGNMENT);
+        layout.linesOffset[side] = offset;
+        offset = alignOffset(offset + entries * sizeof(uint32_t), HUBLABEL_ALIGNMENT);
+    }
+    layout.fileSize = offset;
+
+    // Fill the image in place
+    image.assign(offset / sizeof(uint64_t), 0);
+    uint8_t* base = reinterpret_cast<uint8_t*>(image.data());
+    memcpy(base, &layout, sizeof(layout));
+    memcpy(base + layout.hubNodesOffset, order.data(), n * sizeof(uint32_t));
+    for (int side = 0; side < sides; side++) {
+        uint64_t* labelOffsets = reinterpret_cast<uint64_t*>(base + layout.offsetsOffset[side]);
+        uint32_t* labelHubs = reinterpret_cast<uint32_t*>(base + layout.hubsOffset[side]);
+        double* labelDistances = reinterpret_cast<double*>(base + layout.distancesOffset[side]);
+        uint32_t* labelParents = reinterpret_cast<uint32_t*>(base + layout.parentsOffset[side]);
+        uint32_t* labelLines = reinterpret_cast<uint32_t*>(base + layout.linesOffset[side]);
+
+        uint64_t k = 0;
+        for (size_t v = 0; v < n; v++) {
+            labelOffsets[v] = k;
+            for (const LabelEntry& e : labels[side][v]) {
+                labelHubs[k] = e.hub;
+                labelDistances[k] = e.distance;
+                labelParents[k] = e.parent;
+                labelLines[k] = e.line;
+                k++;
+            }
+            labelHubs[k] = HUBLABEL_END;
+            labelDistances[k] = unreached;
+            labelParents[k] = UINT32_MAX;
+            labelLines[k] = UINT32_MAX;
+            k++;
+            vector<LabelEntry>().swap(labels[side][v]);
+        }
+        labelOffsets[n] = k;
+    }
+
+    data = base;
+    size = offset;
+    return validate();
+}
+
+// ----------------------------------------------
+// Write the image as a file
+// ----------------------------------------------
+bool HubLabels::save(const string& filename) const
+{
+    if (empty()) return false;
+
+    ofstream out(filename, ios::binary | ios::trunc);
+    if (!out.is_open()) {
+        cout << "Hub Label Error: Cannot create file (" << filename << ")" << endl;
+        return false;
+    }
+
+    out.write(reinterpret_cast<const char*>(data), static_cast<streamsize>(size));
+    if (!out.good()) {
+        cout << "Hub Label Error: Write failed (" << filename << ")" << endl;
+        return false;
+    }
+    return true;
+}
+
+// ----------------------------------------------
+// Map a saved image read-only
+// ----------------------------------------------
+bool HubLabels::open(const string& filename)
+{
+    close();
+    if (!file.open(filename)) return false;
+    data = file.data();
+    size = file.size();
+
+    if (!validate()) {
+        cout << "Hub Label Error: Invalid or incompatible file (" << filename << ")" << endl;
+        close();
+        return false;
+    }
+    return true;
+}
+
+void HubLabels::close()
+{
+    file.close();
+    vector<uint64_t>().swap(image);
+
+    data = nullptr;
+    size = 0;
+    header = nullptr;
+}
+
+// Checks the header against the image size and points the arrays into the image
+bool HubLabels::validate()
+{
+    if (size < sizeof(HubLabelHeader)) return false;
+    const HubLabelHeader* h = reinterpret_cast<const HubLabelHeader*>(data);
+
+    if (memcmp(h->magic, HUBLABEL_MAGIC, sizeof(h->magic)) != 0) return false;
+    if (h->version != HUBLABEL_VERSION || h->headerSize != sizeof(HubLabelHeader)) return false;
+    if (h->fileSize != size || h->nodeCount >= UINT32_MAX) return false;
+
+    uint64_t n = h->nodeCount;
+    int sides = h->symmetric ? 1 : 2;
+
+    // Every section must be aligned and lie inside the image
+    auto fits = [&](uint64_t offset, uint64_t bytes) { return sectionFits(offset, bytes, size, HUBLABEL_ALIGNMENT); };
+    if (!fits(h->hubNodesOffset, n * sizeof(uint32_t))) return false;
+    for (int side = 0; side < sides; side++) {
+        uint64_t m = h->entryCount[side];
+        if (!fits(h->offsetsOffset[side], (n + 1) * sizeof(uint64_t)) ||
+            !fits(h->hubsOffset[side], m * sizeof(uint32_t)) ||
+            !fits(h->distancesOffset[side], m * sizeof(double)) ||
+            !fits(h->parentsOffset[side], m * sizeof(uint32_t)) ||
+            !fits(h->linesOffset[side], m * sizeof(uint32_t))) return false;
+    }
+
+    hubNodes = reinterpret_cast<const uint32_t*>(data + h->hubNodesOffset);
+    for (int side = 0; side < 2; side++) {
+        int stored = side < sides ? side : 0;
+        offsets[side] = reinterpret_cast<const uint64_t*>(data + h->offsetsOffset[stored]);
+        hubs[side] = reinterpret_cast<const uint32_t*>(data + h->hubsOffset[stored]);
+        distances[side] = reinterpret_cast<const double*>(data + h->distancesOffset[stored]);
+        parents[side] = reinterpret_cast<const uint32_t*>(data + h->parentsOffset[stored]);
+        lines[side] = reinterpret_cast<const uint32_t*>(data + h->linesOffset[stored]);
+    }
+
+    // Only the O(1) boundary entries are checked, the arrays stay untouched
+    for (int side = 0; side < sides; side++) {
+        uint64_t m = h->entryCount[side];
+        if (offsets[side][n] != m || (m > 0 && hubs[side][m - 1] != HUBLABEL_END)) return false;
+    }
+    header = h;
+    return true;
+}
+
+double HubLabels::averageLabelSize() const
+{
+    if (empty() || header->nodeCount == 0) return 0.0;
+    int sides = header->symmetric ? 1 : 2;
+    uint64_t entries = 0;
+    for (int side = 0; side < sides; side++) entries += header->entryCount[side] - header->nodeCount;
+    return static_cast<double>(entries) / (sides * header->nodeCount);
+}
+
+uint64_t HubLabels::findEntry(int side, uint32_t v, uint32_t hub) const
+{
+    const uint32_t* first = hubs[side] + offsets[side][v];
+    const uint32_t* last = hubs[side] + offsets[side][v + 1] - 1;   // Without the terminator
+    return static_cast<uint64_t>(lower_bound(first, last, hub) - hubs[side]);
+}
+
+double HubLabels::distance(uint32_t s, uint32_t t, uint32_t* hub, size_t* scanned) const
+{
+    double best = numeric_limits<double>::infinity();
+    if (hub) *hub = HUBLABEL_END;
+    if (scanned) *scanned = 0;
+    if (empty() || s >= header->nodeCount || t >= header->nodeCount) return best;
+
+    // Merge-join; both labels end with HUBLABEL_END, so no bounds checks
+    const uint32_t* a = hubs[0] + offsets[0][s];
+    const uint32_t* b = hubs[1] + offsets[1][t];
+    const double* da = distances[0] + offsets[0][s];
+    const double* db = distances[1] + offsets[1][t];
+    size_t i = 0, j = 0;
+    uint32_t bestHub = HUBLABEL_END;
+    while (true) {
+        uint32_t x = a[i], y = b[j];
+        if (x == y) {
+            if (x == HUBLABEL_END) break;
+            double d = da[i] + db[j];
+            if (d < best) {
+                best = d;
+                bestHub = x;
+            }
+        }
+        i += x <= y;
+        j += y <= x;
+    }
+
+    if (hub) *hub = bestHub;
+    if (scanned) *scanned = i + j;
+    return best;
+}
+
+PathResult<uint32_t, double> HubLabels::path(uint32_t s, uint32_t t, size_t* scanned) const
+{
+    PathResult<uint32_t, double> result;
+    uint32_t hub;
+    double d = distance(s, t, &hub, scanned);
+    if (hub == HUBLABEL_END) return result;
+    result.found = true;
+    result.distance = d;
+
+    // s -> hub along the forward parents; every step is bounded by the node count
+    uint32_t hubNode = hubNodes[hub];
+    result.nodes.push_back(s);
+    for (uint32_t v = s, steps = 0; v != hubNode && steps < header->nodeCount; steps++) {
+        uint64_t e = findEntry(0, v, hub);
+        result.lines.push_back(lines[0][e]);
+        v = parents[0][e];
+        result.nodes.push_back(v);
+    }
+
+    // hub -> t: the backward parents lead from t to the hub
+    vector<pair<uint32_t, uint32_t>> tail;
+    for (uint32_t v = t, steps = 0; v != hubNode && steps < header->nodeCount; steps++) {
+        uint64_t e = findEntry(1, v, hub);
+        tail.push_back({ v, lines[1][e] });
+        v = parents[1][e];
+    }
+    for (auto it = tail.rbegin(); it != tail.rend(); ++it) {
+        result.lines.push_back(it->second);
+        result.nodes.push_back(it->first);
+    }
+    return result;
+}
+
+PathResult<uint32_t, double> HubLabelQuery::run(uint32_t source, uint32_t target)
+{
+    if (withPath) return labels.path(source, target, &scanned);
+
+    PathResult<uint32_t, double> result;
+    result.distance = labels.distance(source, target, nullptr, &scanned);
+    result.found = result.distance != numeric_limits<double>::infinity();
+    return result;
+}
+
+template bool HubLabels::build(const Graph<size_t, double>&, const ContractionHierarchy&, uint64_t);
+template bool HubLabels::build(const ProfileGraph<Graph<size_t, double>>&, const ContractionHierarchy&, uint64_t);
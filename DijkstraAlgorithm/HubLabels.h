@@ -0,0 +1,159 @@
+#pragma once
+
+#ifndef HUBLABELS_H
+#define HUBLABELS_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include "Graph.h"
+#include "ShortestPathQuery.h"
+#include "ContractionHierarchy.h"
+#include "MappedFile.h"
+
+using namespace std;
+
+// ------------------------------------------------------------
+// Hub label image
+//
+// File layout (native endianness, every section 64-byte aligned):
+//   HubLabelHeader
+//   hubNodes        uint32[nodes]         hub index -> node id
+// then per side (0 = forward labels d(v, hub), 1 = backward labels
+// d(hub, v); side 1 is not stored for symmetric graphs):
+//   offsets         uint64[nodes + 1]     label of v = [offsets[v], offsets[v + 1])
+//   hubs            uint32[entries]       ascending hub index, ends with UINT32_MAX
+//   distances       double[entries]
+//   parents         uint32[entries]       next node from v towards the hub (forward),
+//                                         previous node from the hub to v (backward)
+//   lines           uint32[entries]       line id of that step
+//
+// The image is used in place, either built in memory or mapped
+// read-only from a saved file (nothing is parsed or copied).
+// ------------------------------------------------------------
+#define HUBLABEL_MAGIC "DJKHUBL"
+#define HUBLABEL_VERSION 1
+#define HUBLABEL_ALIGNMENT 64
+
+// Hub index of the label terminator
+#define HUBLABEL_END UINT32_MAX
+
+struct HubLabelHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    uint64_t nodeCount;
+    uint64_t entryCount[2];     // Entries per side, terminators included
+    uint64_t fingerprint;       // weightFingerprint() of the graph the labels belong to
+    uint64_t fileSize;
+    uint32_t symmetric;         // 1 if side 1 is not stored (labels serve both directions)
+    uint32_t reserved;
+
+    // Byte offsets of the sections from the start of the image
+    uint64_t hubNodesOffset;
+    uint64_t offsetsOffset[2];
+    uint64_t hubsOffset[2];
+    uint64_t distancesOffset[2];
+    uint64_t parentsOffset[2];
+    uint64_t linesOffset[2];
+};
+
+// ------------------------------------------------------------
+// Hub labeling distance oracle. Every node v keeps a forward label
+// (hubs reachable from v with d(v, hub)) and a backward label (hubs
+// reaching v); for every pair s, t some hub on a shortest path is in
+// both labels, so
+//   d(s, t) = min over common hubs h of d(s, h) + d(h, t),
+// a merge-join of two short sorted arrays without any graph access.
+// Built by pruned labeling: one Dijkstra search per hub in CH order
+// (most important first), each stopping at nodes whose distance the
+// labels built so far already give. Paths follow the stored parent
+// steps from both ends to the meeting hub.
+// Node ids are those of the graph the labels were built on.
+// ------------------------------------------------------------
+class HubLabels
+{
+private:
+    const uint8_t* data = nullptr;  // Image in use: 'image' or the mapped file
+    size_t size = 0;
+    vector<uint64_t> image;         // Owned image after build (empty when mapped)
+    MappedFile file;                // Saved image after open() (closed when built)
+
+    const HubLabelHeader* header = nullptr;
+    const uint32_t* hubNodes = nullptr;
+    const uint64_t* offsets[2] = {};
+    const uint32_t* hubs[2] = {};
+    const double* distances[2] = {};
+    const uint32_t* parents[2] = {};
+    const uint32_t* lines[2] = {};
+
+    bool validate();
+
+    // Entry of 'hub' in the label of v on one side (binary search)
+    uint64_t findEntry(int side, uint32_t v, uint32_t hub) const;
+
+public:
+    HubLabels() = default;
+    ~HubLabels() { close(); }
+
+    HubLabels(const HubLabels&) = delete;
+    HubLabels& operator=(const HubLabels&) = delete;
+
+    // Computes the labels of the graph in the contraction order of 'hierarchy'
+    // (built on the same graph); false if the two do not match
+    template <typename GraphType>
+    bool build(const GraphType& graph, const ContractionHierarchy& hierarchy, uint64_t graphFingerprint);
+
+    // Writes the image; open() maps it back
+    bool save(const string& filename) const;
+
+    // Maps a saved image; returns false (and stays closed) if it is missing or malformed
+    bool open(const string& filename);
+    void close();
+
+    bool empty() const { return header == nullptr; }
+    bool isMapped() const { return file.isOpen(); }
+    size_t nodeCount() const { return header ? header->nodeCount : 0; }
+    size_t bytes() const { return size; }
+    uint64_t getFingerprint() const { return header ? header->fingerprint : 0; }
+
+    // Label entries per node and side, terminators excluded
+    double averageLabelSize() const;
+
+    // Length of the shortest path from s to t (infinity if none); 'hub' receives the meeting hub
+    // and 'scanned' the label entries read
+    double distance(uint32_t s, uint32_t t, uint32_t* hub = nullptr, size_t* scanned = nullptr) const;
+
+    // Shortest path from s to t through the meeting hub
+    PathResult<uint32_t, double> path(uint32_t s, uint32_t t, size_t* scanned = nullptr) const;
+};
+
+// ------------------------------------------------------------
+// Query interface over HubLabels (as the other query classes):
+// paths by default, or distances only
+// ------------------------------------------------------------
+class HubLabelQuery
+{
+public:
+    typedef uint32_t NodeId;
+    typedef double Weight;
+
+private:
+    const HubLabels& labels;
+    bool withPath;
+    size_t scanned = 0;
+
+public:
+    explicit HubLabelQuery(const HubLabels& labels, bool withPath = true) : labels(labels), withPath(withPath) {}
+
+    PathResult<uint32_t, double> run(uint32_t source, uint32_t target);
+
+    // Label entries read by the last run
+    size_t settledCount() const { return scanned; }
+};
+
+extern template bool HubLabels::build(const Graph<size_t, double>&, const ContractionHierarchy&, uint64_t);
+extern template bool HubLabels::build(const ProfileGraph<Graph<size_t, double>>&, const ContractionHierarchy&, uint64_t);
+
+#endif
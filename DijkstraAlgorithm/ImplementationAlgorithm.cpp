@@ -1,7 +1,11 @@
 ﻿#include "ImplementationAlgorithm.h"
 #include "Interface.h"
-#include <queue>
+#include "GraphVersion.h"
+#include "ShortestPathQuery.h"
+#include <thread>
 #include <limits>
+#include <algorithm>
+#include <cmath>
 
 using namespace std;
 
@@ -14,211 +18,460 @@ void visualizationSleep() {
     }
 }
 
+const char* searchModeName(SearchMode mode)
+{
+    switch (mode) {
+    case SEARCH_BIDIRECTIONAL: return "Bidirectional Dijkstra";
+    case SEARCH_ASTAR: return "A*";
+    case SEARCH_ALT: return "ALT (landmarks)";
+    case SEARCH_CH: return "Contraction hierarchy";
+    case SEARCH_CCH: return "Customizable contraction hierarchy";
+    case SEARCH_HUB_LABELS: return "Hub labels";
+    case SEARCH_ARC_FLAGS: return "Arc flags";
+    case SEARCH_TRANSIT_NODES: return "Transit node routing";
+    case SEARCH_COMPRESSED: return "Dijkstra (compressed adjacency)";
+    default: return "Dijkstra";
+    }
+}
+
 // -----------------------------------------------------------
-// Custom comparator for priority queue
-// Implements a min-heap based on distance (second value)
+// Takes the path of a query (only the start point if none)
 // -----------------------------------------------------------
-struct CompareDist {
-    bool operator()(const pair<int, double>& a, const pair<int, double>& b) const {
-        return a.second > b.second;  // min-heap
+static void takePath(PathResult<uint32_t, double>&& result, uint32_t startIndex, vector<uint32_t>& pathNodes, vector<uint32_t>& pathLines)
+{
+    if (!result.found) {
+        pathNodes.push_back(startIndex);
+        return;
     }
-};
+    pathNodes = move(result.nodes);
+    pathLines = move(result.lines);
+}
 
 // -----------------------------------------------------------
-// Main Dijkstra shortest path implementation with visualization
-// Returns (pathString, totalPathWeight)
+// Animation of plain Dijkstra: every tested arc flashes as
+// accepted or rejected, then the current predecessor tree is
+// redrawn (points reached so far, and the line each was last
+// improved through)
 // -----------------------------------------------------------
-pair<string, double> findShortestPath(const vector<Point>& points, const vector<Line>& lines)
+class TreeAnimation : public SearchObserver
 {
-    double path = 0;
-    string pathStr;
-    int startIndex = -1, endIndex = -1;
-
-    // -------------------------------------
-    // Locate start and end points
-    // -------------------------------------
+private:
+    const PointStore& points;
+    VisualState& visual;
+    uint32_t startIndex, endIndex;
+    vector<uint32_t> treeLine;  // Line that last improved each point
+    vector<uint8_t> reached;
+
+public:
+    TreeAnimation(const PointStore& points, VisualState& visual, uint32_t startIndex, uint32_t endIndex)
+        : points(points), visual(visual), startIndex(startIndex), endIndex(endIndex),
+          treeLine(points.capacity(), INVALID_LINE_ID), reached(points.capacity(), 0)
     {
-        lock_guard<mutex> lock(dataMutex);
-        for (size_t i = 0; i < points.size(); i++) {
-            if (points[i].getIsStartPoint()) startIndex = i;
-            if (points[i].getIsEndPoint())   endIndex = i;
-        }
+        reached[startIndex] = 1;
     }
 
-    if (startIndex == -1 || endIndex == -1) {
-        cout << "Algorithm Error: Start or End point not defined\n";
-        return make_pair(string(), 0.0);
+    void onSettle(size_t node, int) override {
+        {
+            lock_guard<mutex> lock(visual.getMutex());
+            visual.setNodeColor(static_cast<uint32_t>(node), ACTIVE_COLOR_POINT);
+        }
+        visualizationSleep();
     }
 
-    // -------------------------------------
-    // Initialize Dijkstra data structures
-    // -------------------------------------
-    vector<double> dist(points.size(), numeric_limits<double>::infinity());
-    vector<int> prev(points.size(), -1);
+    void onRelax(size_t, size_t to, size_t lineId, bool improved, int) override {
+        // Highlight current edge being tested
+        {
+            lock_guard<mutex> lock(visual.getMutex());
+            visual.setEdge(static_cast<uint32_t>(lineId), ACTIVE_COLOR_LINE, ACTIVE_BOLDNESS_LINE);
+        }
+        visualizationSleep();
 
-    priority_queue<pair<int, double>, vector<pair<int, double>>, CompareDist> pq;
+        // Accepted or rejected edge animation
+        {
+            lock_guard<mutex> lock(visual.getMutex());
+            if (improved) {
+                treeLine[to] = static_cast<uint32_t>(lineId);
+                reached[to] = 1;
+                visual.setEdge(static_cast<uint32_t>(lineId), ACCEPT_COLOR_LINE, ACTIVE_BOLDNESS_LINE);
+                visual.setNodeColor(static_cast<uint32_t>(to), ANALYSE_COLOR_POINT);
+            }
+            else {
+                visual.setEdge(static_cast<uint32_t>(lineId), REJECTED_COLOR_LINE, ACTIVE_BOLDNESS_LINE);
+            }
+        }
+        visualizationSleep();
 
-    dist[startIndex] = 0.0;
-    pq.push({ startIndex, 0.0 });
+        // Reset all edges, then redraw points and the predecessor tree
+        lock_guard<mutex> lock(visual.getMutex());
+        visual.clearEdges();
+        for (uint32_t j = 0; j < points.capacity(); j++) {
+            if (!points.isOccupied(j)) continue;
 
-    // -------------------------------------
-    // Dijkstra main loop
-    // -------------------------------------
-    while (!pq.empty()) {
-        auto [u, d] = pq.top();
-        pq.pop();
+            if (j == startIndex) visual.setNodeColor(j, START_COLOR_POINT);
+            else if (j == endIndex) visual.setNodeColor(j, END_COLOR_POINT);
+            else visual.setNodeColor(j, reached[j] ? POSSIBLE_SOLUTION_COLOR_POINT : BASE_COLOR_POINT);
 
-        // If reached the destination — stop early
-        if (points[u].getIsEndPoint()) break;
-        if (d > dist[u]) continue;  // Skip outdated values
+            if (treeLine[j] != INVALID_LINE_ID) visual.setEdge(treeLine[j], POSSIBLE_SOLUTION_COLOR_LINE, ACTIVE_BOLDNESS_LINE);
+        }
+    }
+};
 
-        // Animate current active point
-        if (ANIMATION_DELAY > 0) {
-            lock_guard<mutex> lock(dataMutex);
-            const_cast<Point&>(points[u]).setColor(ACTIVE_COLOR_POINT, true);
+// -----------------------------------------------------------
+// Classic Dijkstra (DijkstraQuery) on the live adjacency, stopping
+// when the end point is settled. Animates every relaxation and the
+// current predecessor tree.
+// Fills the path (nodes from start to end, lines between them)
+// -----------------------------------------------------------
+static void dijkstraSearch(const GraphVersion& graph, VisualState& visual, size_t profile,
+    uint32_t startIndex, uint32_t endIndex, vector<uint32_t>& pathNodes, vector<uint32_t>& pathLines)
+{
+    VersionGraph weighted(graph, profile);
+    DijkstraQuery<VersionGraph> query(weighted);
+    TreeAnimation animation(graph.getPoints(), visual, startIndex, endIndex);
+    if (ANIMATION_DELAY > 0) query.setObserver(&animation);
+    takePath(query.run(startIndex, endIndex), startIndex, pathNodes, pathLines);
+}
+
+// -----------------------------------------------------------
+// Animation of the searches that grow a frontier (bidirectional,
+// A*, ALT, arc flags): settled points take the color of their
+// side, improved arcs are highlighted (and the points they reach,
+// for one-sided searches)
+// -----------------------------------------------------------
+class FrontierAnimation : public SearchObserver
+{
+private:
+    VisualState& visual;
+    bool markReached;
+
+public:
+    FrontierAnimation(VisualState& visual, bool markReached) : visual(visual), markReached(markReached) {}
+
+    void onSettle(size_t node, int side) override {
+        {
+            lock_guard<mutex> lock(visual.getMutex());
+            visual.setNodeColor(static_cast<uint32_t>(node), side == 0 ? ACTIVE_COLOR_POINT : ANALYSE_COLOR_POINT);
         }
         visualizationSleep();
+    }
 
-        // -------------------------------------
-        // Iterate over all edges to find neighbors
-        // -------------------------------------
-        for (size_t i = 0; i < lines.size(); i++) {
-            const Line& line = lines[i];
-            size_t v = -1;
+    void onRelax(size_t, size_t to, size_t lineId, bool improved, int) override {
+        if (!improved) return;
+        lock_guard<mutex> lock(visual.getMutex());
+        visual.setEdge(static_cast<uint32_t>(lineId), POSSIBLE_SOLUTION_COLOR_LINE, ACTIVE_BOLDNESS_LINE);
+        if (markReached) visual.setNodeColor(static_cast<uint32_t>(to), ANALYSE_COLOR_POINT);
+    }
+};
 
-            {
-                lock_guard<mutex> lock(dataMutex);
-                if (line.getStart() == points[u])
-                    v = find(points.begin(), points.end(), line.getEnd()) - points.begin();
-                else if (line.getEnd() == points[u])
-                    v = find(points.begin(), points.end(), line.getStart()) - points.begin();
-            }
+// -----------------------------------------------------------
+// Runs a query class on the live adjacency, animated by the
+// observer while ANIMATION_DELAY is set, and takes its path
+// -----------------------------------------------------------
+template <typename Query>
+static void runQuery(Query& query, SearchObserver& animation, uint32_t startIndex, uint32_t endIndex,
+    vector<uint32_t>& pathNodes, vector<uint32_t>& pathLines)
+{
+    if (ANIMATION_DELAY > 0) query.setObserver(&animation);
+    takePath(query.run(startIndex, endIndex), startIndex, pathNodes, pathLines);
+}
 
-            if (v >= points.size()) continue;
+// -----------------------------------------------------------
+// Bidirectional Dijkstra (BidirectionalDijkstraQuery); settled
+// points are animated in the color of their side
+// -----------------------------------------------------------
+static void bidirectionalSearch(const GraphVersion& graph, VisualState& visual, size_t profile,
+    uint32_t startIndex, uint32_t endIndex, vector<uint32_t>& pathNodes, vector<uint32_t>& pathLines)
+{
+    VersionGraph weighted(graph, profile);
+    BidirectionalDijkstraQuery<VersionGraph> query(weighted);
+    FrontierAnimation animation(visual, false);
+    runQuery(query, animation, startIndex, endIndex, pathNodes, pathLines);
+}
 
-            // Highlight current edge being tested
-            if (ANIMATION_DELAY > 0) {
-                lock_guard<mutex> lock(dataMutex);
-                const_cast<Line&>(line).setColor(ACTIVE_COLOR_LINE, true);
-                const_cast<Line&>(line).setBoldness(ACTIVE_BOLDNESS_LINE, true);
-            }
-            visualizationSleep();
+// -----------------------------------------------------------
+// A* (AStarQuery) with scale * straight-line distance to the end
+// point. The scale (see euclideanPotentialScale) keeps the
+// potential consistent; when the weights allow none it runs plain
+// Dijkstra.
+// -----------------------------------------------------------
+static void astarSearch(const GraphVersion& graph, VisualState& visual, size_t profile,
+    uint32_t startIndex, uint32_t endIndex, vector<uint32_t>& pathNodes, vector<uint32_t>& pathLines)
+{
+    const PointStore& points = graph.getPoints();
 
-            // Relaxation step
-            double alt = dist[u] + line.getWeight();
-
-            if (alt < dist[v]) {
-                // Found a better path
-                dist[v] = alt;
-                prev[v] = u;
-                pq.push({ v, alt });
-
-                // Accepted edge animation
-                if (ANIMATION_DELAY > 0) {
-                    lock_guard<mutex> lock(dataMutex);
-                    const_cast<Line&>(line).setColor(ACCEPT_COLOR_LINE, true);
-                    const_cast<Line&>(line).setBoldness(ACTIVE_BOLDNESS_LINE, true);
-                    const_cast<Point&>(points[v]).setColor(ANALYSE_COLOR_POINT, true);
-                }
-            }
-            else {
-                // Rejected edge animation
-                if (ANIMATION_DELAY > 0) {
-                    lock_guard<mutex> lock(dataMutex);
-                    const_cast<Line&>(line).setColor(REJECTED_COLOR_LINE, true);
-                    const_cast<Line&>(line).setBoldness(ACTIVE_BOLDNESS_LINE, true);
-                }
-            }
+    double scale = euclideanPotentialScale(points, graph.getLines(), graph.getProfiles(), profile);
+    if (scale == 0) {
+        cout << "A* potential not consistent for these weights, using Dijkstra\n";
+        dijkstraSearch(graph, visual, profile, startIndex, endIndex, pathNodes, pathLines);
+        return;
+    }
 
-            visualizationSleep();
+    VersionGraph weighted(graph, profile);
+    vector<double> xs(weighted.nodeCount(), 0.0), ys(weighted.nodeCount(), 0.0);
+    for (auto it = points.begin(); it != points.end(); ++it) {
+        xs[it.slot()] = it->getX();
+        ys[it.slot()] = it->getY();
+    }
+    AStarQuery<VersionGraph> query(weighted, EuclideanPotential(xs, ys, scale));
+    FrontierAnimation animation(visual, true);
+    runQuery(query, animation, startIndex, endIndex, pathNodes, pathLines);
+}
 
-            // -------------------------------------
-            // Reset and redraw all edges and points
-            // to visualize current shortest-path tree
-            // -------------------------------------
-            if (ANIMATION_DELAY > 0) {
-                lock_guard<mutex> lock(dataMutex);
-
-                // Reset all edges to base color
-                for (const auto& l : lines) {
-                    const_cast<Line&>(l).setColor(BASE_COLOR_LINE, true);
-                    const_cast<Line&>(l).setBoldness(BASE_BOLDNESS_LINE, true);
-                }
-
-                // Rebuild partial shortest-path tree visualization
-                for (size_t j = 0; j < points.size(); j++) {
-
-                    // Color visited and non-visited nodes
-                    if (dist[j] != numeric_limits<double>::infinity() && j != startIndex && j != endIndex)
-                        const_cast<Point&>(points[j]).setColor(POSSIBLE_SOLUTION_COLOR_POINT, true);
-                    else if (j != startIndex && j != endIndex)
-                        const_cast<Point&>(points[j]).setColor(BASE_COLOR_POINT, true);
-                    else if (j == startIndex)
-                        const_cast<Point&>(points[j]).setColor(START_COLOR_POINT, true);
-                    else if (j == endIndex)
-                        const_cast<Point&>(points[j]).setColor(END_COLOR_POINT, true);
-
-                    // Draw blue edges representing the current predecessor tree
-                    if (prev[j] != -1) {
-                        for (const Line& l : lines) {
-                            if ((l.getStart() == points[j] && l.getEnd() == points[prev[j]]) ||
-                                (l.getEnd() == points[j] && l.getStart() == points[prev[j]])) {
-
-                                const_cast<Line&>(l).setColor(POSSIBLE_SOLUTION_COLOR_LINE, true);
-                                const_cast<Line&>(l).setBoldness(ACTIVE_BOLDNESS_LINE, true);
-                                break;
-                            }
-                        }
-                    }
-                }
-            }
-        }
+// -----------------------------------------------------------
+// Index modes: a prepared index is used only if it exists, covers
+// both points and was built for this graph and profile (same
+// weight fingerprint); otherwise the query says so and runs plain
+// Dijkstra instead (returns false)
+// -----------------------------------------------------------
+static bool isPrepared(const CustomizableHierarchy& index) { return index.isCustomized(); }
+
+template <typename Index>
+static bool isPrepared(const Index& index) { return !index.empty(); }
+
+template <typename Index>
+static bool indexUsable(const Index* index, const char* name, const GraphVersion& graph, VisualState& visual, size_t profile,
+    uint64_t fingerprint, uint32_t startIndex, uint32_t endIndex, vector<uint32_t>& pathNodes, vector<uint32_t>& pathLines)
+{
+    if (index && isPrepared(*index) && static_cast<size_t>(max(startIndex, endIndex)) < index->nodeCount()
+        && index->getFingerprint() == fingerprint) {
+        return true;
     }
 
-    // -----------------------------------------------------------
-    // Final path reconstruction (with animation)
-    // -----------------------------------------------------------
-    {
-        lock_guard<mutex> lock(dataMutex);
-        for (size_t v = endIndex; v != -1 && prev[v] != -1; v = prev[v]) {
+    cout << name << " missing or out of date, using Dijkstra\n";
+    dijkstraSearch(graph, visual, profile, startIndex, endIndex, pathNodes, pathLines);
+    return false;
+}
+
+// -----------------------------------------------------------
+// ALT: A* (AStarQuery) with the landmark lower bounds. The table
+// must belong to this graph and profile (same weight fingerprint);
+// otherwise it runs plain Dijkstra.
+// -----------------------------------------------------------
+static void altSearch(const GraphVersion& graph, VisualState& visual, size_t profile, uint64_t fingerprint, const LandmarkTable* landmarks,
+    uint32_t startIndex, uint32_t endIndex, vector<uint32_t>& pathNodes, vector<uint32_t>& pathLines)
+{
+    if (!indexUsable(landmarks, "Landmarks", graph, visual, profile, fingerprint, startIndex, endIndex, pathNodes, pathLines)) return;
 
-            // Build path string backwards
-            pathStr = points[v].getName() + (pathStr.empty() ? "" : "->") + pathStr;
+    VersionGraph weighted(graph, profile);
+    AStarQuery<VersionGraph, LandmarkPotential> query(weighted, LandmarkPotential(*landmarks));
+    FrontierAnimation animation(visual, true);
+    runQuery(query, animation, startIndex, endIndex, pathNodes, pathLines);
+}
 
-            // Find and mark edges belonging to final shortest path
-            for (const Line& line : lines) {
-                if ((line.getStart() == points[v] && line.getEnd() == points[prev[v]]) ||
-                    (line.getEnd() == points[v] && line.getStart() == points[prev[v]])) {
+// -----------------------------------------------------------
+// Arc flags: Dijkstra over the lines flagged for the end point's
+// cell (ArcFlagQuery), animated like A*. The flags must belong to
+// this graph and profile; otherwise it runs plain Dijkstra.
+// -----------------------------------------------------------
+static void arcFlagSearch(const GraphVersion& graph, VisualState& visual, size_t profile, uint64_t fingerprint, const ArcFlags* arcFlags,
+    uint32_t startIndex, uint32_t endIndex, vector<uint32_t>& pathNodes, vector<uint32_t>& pathLines)
+{
+    if (!indexUsable(arcFlags, "Arc flags", graph, visual, profile, fingerprint, startIndex, endIndex, pathNodes, pathLines)) return;
 
-                    path += line.getWeight();
-                    const_cast<Line&>(line).setIsInPath(true);
+    VersionGraph weighted(graph, profile);
+    ArcFlagQuery<VersionGraph> query(weighted, *arcFlags);
+    FrontierAnimation animation(visual, true);
+    runQuery(query, animation, startIndex, endIndex, pathNodes, pathLines);
+}
 
-                    if (ANIMATION_DELAY > 0) {
-                        const_cast<Line&>(line).setColor(IS_PATH_COLOR_LINE, true);
-                        const_cast<Line&>(line).setBoldness(IS_PATH_BOLDNESS_LINE, true);
-                        visualizationSleep();
-                    }
+// -----------------------------------------------------------
+// Dijkstra (DijkstraQuery) on the compressed adjacency, animated
+// like the plain search. It must be built for this graph and
+// profile; otherwise it runs plain Dijkstra on the live adjacency.
+// -----------------------------------------------------------
+static void compressedSearch(const GraphVersion& graph, VisualState& visual, size_t profile, uint64_t fingerprint, const CompressedGraph* compressed,
+    uint32_t startIndex, uint32_t endIndex, vector<uint32_t>& pathNodes, vector<uint32_t>& pathLines)
+{
+    if (!indexUsable(compressed, "Compressed adjacency", graph, visual, profile, fingerprint, startIndex, endIndex, pathNodes, pathLines)) return;
 
-                    break;
-                }
-            }
+    DijkstraQuery<CompressedGraph> query(*compressed);
+    TreeAnimation animation(graph.getPoints(), visual, startIndex, endIndex);
+    runQuery(query, animation, startIndex, endIndex, pathNodes, pathLines);
+}
 
-            if (ANIMATION_DELAY > 0) {
-                const_cast<Point&>(points[v]).setColor(SOLUTION_COLOR_POINT, true);
-                visualizationSleep();
-            }
-        }
+// -----------------------------------------------------------
+// Contraction hierarchy query; only the resulting path is animated
+// (the upward searches run on the hierarchy, not the adjacency).
+// The hierarchy must belong to this graph and profile; otherwise
+// it runs plain Dijkstra.
+// -----------------------------------------------------------
+static void hierarchySearch(const GraphVersion& graph, VisualState& visual, size_t profile, uint64_t fingerprint, const ContractionHierarchy* hierarchy,
+    uint32_t startIndex, uint32_t endIndex, vector<uint32_t>& pathNodes, vector<uint32_t>& pathLines)
+{
+    if (!indexUsable(hierarchy, "Contraction hierarchy", graph, visual, profile, fingerprint, startIndex, endIndex, pathNodes, pathLines)) return;
+
+    CHQuery query(*hierarchy);
+    takePath(query.run(startIndex, endIndex), startIndex, pathNodes, pathLines);
+}
+
+// -----------------------------------------------------------
+// Customizable hierarchy query; like the CH query only the path
+// is animated. It must be customized for this graph and profile;
+// otherwise it runs plain Dijkstra.
+// -----------------------------------------------------------
+static void customizableSearch(const GraphVersion& graph, VisualState& visual, size_t profile, uint64_t fingerprint, const CustomizableHierarchy* hierarchy,
+    uint32_t startIndex, uint32_t endIndex, vector<uint32_t>& pathNodes, vector<uint32_t>& pathLines)
+{
+    if (!indexUsable(hierarchy, "Customizable hierarchy", graph, visual, profile, fingerprint, startIndex, endIndex, pathNodes, pathLines)) return;
+
+    CCHQuery query(*hierarchy);
+    takePath(query.run(startIndex, endIndex), startIndex, pathNodes, pathLines);
+}
+
+// -----------------------------------------------------------
+// Hub label lookup; the path comes from the labels' parent steps.
+// The labels must belong to this graph and profile; otherwise it
+// runs plain Dijkstra.
+// -----------------------------------------------------------
+static void hubLabelSearch(const GraphVersion& graph, VisualState& visual, size_t profile, uint64_t fingerprint, const HubLabels* labels,
+    uint32_t startIndex, uint32_t endIndex, vector<uint32_t>& pathNodes, vector<uint32_t>& pathLines)
+{
+    if (!indexUsable(labels, "Hub labels", graph, visual, profile, fingerprint, startIndex, endIndex, pathNodes, pathLines)) return;
+
+    takePath(labels->path(startIndex, endIndex), startIndex, pathNodes, pathLines);
+}
+
+// -----------------------------------------------------------
+// Transit node routing: long queries are answered from the tables
+// (the hierarchy only unpacks their path), local ones run the CH
+// query. Both must belong to this graph and profile; otherwise it
+// runs plain Dijkstra.
+// -----------------------------------------------------------
+static void transitSearch(const GraphVersion& graph, VisualState& visual, size_t profile, uint64_t fingerprint,
+    const TransitNodeRouting* routing, const ContractionHierarchy* hierarchy, uint32_t startIndex, uint32_t endIndex,
+    vector<uint32_t>& pathNodes, vector<uint32_t>& pathLines)
+{
+    if (!indexUsable(routing, "Transit nodes", graph, visual, profile, fingerprint, startIndex, endIndex, pathNodes, pathLines)
+        || !indexUsable(hierarchy, "Contraction hierarchy", graph, visual, profile, fingerprint, startIndex, endIndex, pathNodes, pathLines)) {
+        return;
+    }
+
+    TransitNodeQuery query(*routing, *hierarchy);
+    PathResult<uint32_t, double> result = query.run(startIndex, endIndex);
+    if (query.localCount() == 0) {
+        cout << "Transit node table: " << result.distance << " from " << query.settledCount() << " lookups\n";
+    }
+    takePath(move(result), startIndex, pathNodes, pathLines);
+}
+
+// -----------------------------------------------------------
+// Main shortest path entry point with visualization
+// Runs on an immutable graph version, so edits made meanwhile do
+// not block it; animation state is published into the VisualState
+// overlay owned by the renderer.
+// Line weights come from the given weight profile; the ALT mode
+// uses the landmark table prepared for it.
+// Returns (pathString, totalPathWeight)
+// -----------------------------------------------------------
+pair<string, double> findShortestPath(const GraphVersion& graph, VisualState& visual, size_t profile, SearchMode mode,
+    const QueryIndexes& indexes)
+{
+    const PointStore& points = graph.getPoints();
+    const LineStore& lines = graph.getLines();
+    const WeightProfiles& profiles = graph.getProfiles();
+
+    double path = 0;
+    string pathStr;
+    uint32_t startIndex = INVALID_POINT_ID, endIndex = INVALID_POINT_ID;
+
+    // -------------------------------------
+    // Locate start and end points
+    // -------------------------------------
+    for (auto it = points.begin(); it != points.end(); ++it) {
+        if (it->getIsStartPoint()) startIndex = it.slot();
+        if (it->getIsEndPoint())   endIndex = it.slot();
+    }
 
-        // Add start point to the string
-        if (startIndex != -1)
-            pathStr = points[startIndex].getName() + (pathStr.empty() ? "" : "->") + pathStr;
+    if (startIndex == INVALID_POINT_ID || endIndex == INVALID_POINT_ID) {
+        cout << "Algorithm Error: Start or End point not defined\n";
+        return make_pair(string(), 0.0);
+    }
+
+    if (profile >= profiles.count()) {
+        cout << "Algorithm Error: Weight profile not defined\n";
+        return make_pair(string(), 0.0);
+    }
+
+    {
+        lock_guard<mutex> lock(visual.getMutex());
+        visual.reset(points.capacity(), lines.capacity());
+    }
+
+    // Prepared indexes are checked against the graph once per query
+    uint64_t fingerprint = indexes.fingerprint != 0 ? indexes.fingerprint : weightFingerprint(lines, profiles, profile);
+
+    // Path from start to end (only the start point if unreachable)
+    vector<uint32_t> pathNodes, pathLines;
+    switch (mode) {
+    case SEARCH_BIDIRECTIONAL:
+        bidirectionalSearch(graph, visual, profile, startIndex, endIndex, pathNodes, pathLines);
+        break;
+    case SEARCH_ASTAR:
+        astarSearch(graph, visual, profile, startIndex, endIndex, pathNodes, pathLines);
+        break;
+    case SEARCH_ALT:
+        altSearch(graph, visual, profile, fingerprint, indexes.landmarks, startIndex, endIndex, pathNodes, pathLines);
+        break;
+    case SEARCH_CH:
+        hierarchySearch(graph, visual, profile, fingerprint, indexes.hierarchy, startIndex, endIndex, pathNodes, pathLines);
+        break;
+    case SEARCH_CCH:
+        customizableSearch(graph, visual, profile, fingerprint, indexes.customizable, startIndex, endIndex, pathNodes, pathLines);
+        break;
+    case SEARCH_HUB_LABELS:
+        hubLabelSearch(graph, visual, profile, fingerprint, indexes.hubLabels, startIndex, endIndex, pathNodes, pathLines);
+        break;
+    case SEARCH_ARC_FLAGS:
+        arcFlagSearch(graph, visual, profile, fingerprint, indexes.arcFlags, startIndex, endIndex, pathNodes, pathLines);
+        break;
+    case SEARCH_TRANSIT_NODES:
+        transitSearch(graph, visual, profile, fingerprint, indexes.transitNodes, indexes.hierarchy, startIndex, endIndex, pathNodes, pathLines);
+        break;
+    case SEARCH_COMPRESSED:
+        compressedSearch(graph, visual, profile, fingerprint, indexes.compressed, startIndex, endIndex, pathNodes, pathLines);
+        break;
+    default:
+        dijkstraSearch(graph, visual, profile, startIndex, endIndex, pathNodes, pathLines);
+    }
+
+    // -----------------------------------------------------------
+    // Final path reconstruction (with animation), from the end back
+    // -----------------------------------------------------------
+    for (size_t i = pathLines.size(); i > 0; i--) {
+        uint32_t v = pathNodes[i];
+
+        // Build path string backwards
+        pathStr = string(points[v].getName()) + (pathStr.empty() ? "" : "->") + pathStr;
+
+        // Mark the edge the node was reached through
+        uint32_t lineId = pathLines[i - 1];
+        path += profiles.get(lines, profile, lineId);
+        {
+            lock_guard<mutex> lock(visual.getMutex());
+            visual.setEdgeInPath(lineId, true);
+            if (ANIMATION_DELAY > 0)
+                visual.setEdge(lineId, IS_PATH_COLOR_LINE, IS_PATH_BOLDNESS_LINE);
+        }
+        if (ANIMATION_DELAY > 0) visualizationSleep();
 
-        // Highlight start and end
         if (ANIMATION_DELAY > 0) {
-            const_cast<Point&>(points[startIndex]).setColor(START_COLOR_POINT, true);
-            const_cast<Point&>(points[endIndex]).setColor(END_COLOR_POINT, true);
+            {
+                lock_guard<mutex> lock(visual.getMutex());
+                visual.setNodeColor(v, SOLUTION_COLOR_POINT);
+            }
+            visualizationSleep();
         }
     }
 
+    // Add start point to the string
+    pathStr = string(points[startIndex].getName()) + (pathStr.empty() ? "" : "->") + pathStr;
+
+    // Highlight start and end
+    if (ANIMATION_DELAY > 0) {
+        lock_guard<mutex> lock(visual.getMutex());
+        visual.setNodeColor(startIndex, START_COLOR_POINT);
+        visual.setNodeColor(endIndex, END_COLOR_POINT);
+    }
+
     return make_pair(pathStr, path);
 }
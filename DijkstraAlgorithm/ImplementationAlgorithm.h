@@ -5,9 +5,50 @@
 #include <vector>
 #include "Point.h"
 #include "Line.h"
+#include "VisualState.h"
+#include "GraphVersion.h"
+#include "Landmarks.h"
+#include "ContractionHierarchy.h"
+#include "CustomizableHierarchy.h"
+#include "HubLabels.h"
+#include "ArcFlags.h"
+#include "TransitNodes.h"
+#include "CompressedGraph.h"
 
 using namespace std;
 
-pair<string, double> findShortestPath(const vector<Point>& points, const vector<Line>& lines);
+// Search strategy of findShortestPath
+enum SearchMode {
+    SEARCH_DIJKSTRA,        // One search from the start point
+    SEARCH_BIDIRECTIONAL,   // Forward and backward searches meeting in the middle
+    SEARCH_ASTAR,           // Goal-directed by the straight-line distance to the end point
+    SEARCH_ALT,             // Goal-directed by landmark distance bounds (needs a landmark table)
+    SEARCH_CH,              // Upward searches in a contraction hierarchy (needs a hierarchy)
+    SEARCH_CCH,             // Same on a customizable hierarchy (re-customized after weight changes)
+    SEARCH_HUB_LABELS,      // Merge of two precomputed labels, no search at all (needs hub labels)
+    SEARCH_ARC_FLAGS,       // Dijkstra over the lines flagged for the end point's cell (needs arc flags)
+    SEARCH_TRANSIT_NODES,   // Table lookups between transit nodes for long queries (needs transit nodes and the CH)
+    SEARCH_COMPRESSED,      // Dijkstra over the varint-compressed adjacency (needs a compressed adjacency)
+    SEARCH_MODE_COUNT
+};
+
+// Display name of a search mode
+const char* searchModeName(SearchMode mode);
+
+// Prepared indexes of the speed-up modes (null if not prepared).
+// Each is only used while it matches the graph's weight fingerprint.
+struct QueryIndexes {
+    uint64_t fingerprint = 0;   // weightFingerprint() of the graph and profile if known (0 = computed by the query)
+    const LandmarkTable* landmarks = nullptr;
+    const ContractionHierarchy* hierarchy = nullptr;
+    const CustomizableHierarchy* customizable = nullptr;
+    const HubLabels* hubLabels = nullptr;
+    const ArcFlags* arcFlags = nullptr;
+    const TransitNodeRouting* transitNodes = nullptr;
+    const CompressedGraph* compressed = nullptr;
+};
+
+pair<string, double> findShortestPath(const GraphVersion& graph, VisualState& visual, size_t profile = 0,
+    SearchMode mode = SEARCH_DIJKSTRA, const QueryIndexes& indexes = QueryIndexes());
 
 #endif
\ No newline at end of file
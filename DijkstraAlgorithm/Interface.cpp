@@ -3,6 +3,10 @@
 #include "FileProcesses.h"
 #include "WindowDraw.h"
 #include "ImplementationAlgorithm.h"
+#include "Benchmark.h"
+#include "GraphSnapshot.h"
+#include "ShortestPathQuery.h"
+#include <chrono>
 #include <vector>
 #include <mutex>
 #include <atomic>
@@ -14,70 +18,88 @@ using namespace std;
 // -------------------------------------------------------------
 #define FILEPOINTS "points.txt"
 #define FILELINES "lines.txt"
+#define FILESNAPSHOT "graph.bin"
+#define FILELANDMARKS "landmarks.bin"
+#define FILEHUBLABELS "hublabels.bin"
 
 // -------------------------------------------------------------
 // Global shared state for console + graphics synchronization
 // -------------------------------------------------------------
-mutex dataMutex;            // protects access to points and lines
+mutex dataMutex;            // serializes edits of the graph (readers use published versions)
 atomic<bool> isRunning(true);   // controls console thread lifetime
 int ANIMATION_DELAY = 0;        // delay for visualization animation
+static string weightProfile = DEFAULT_PROFILE_NAME; // weight profile used by Dijkstra (by name, survives reloads)
+static SearchMode searchMode = SEARCH_DIJKSTRA;     // search strategy used by Dijkstra
+static LandmarkTable landmarks;                     // ALT tables (console thread only)
+static ContractionHierarchy hierarchy;              // CH index (console thread only)
+static CustomizableHierarchy customizable;          // CCH index (console thread only)
+static HubLabels hubLabels;                         // Hub labels, built or mapped (console thread only)
+static ArcFlags arcFlags;                           // Arc flags (console thread only)
+static TransitNodeRouting transitNodes;             // Transit node tables over 'hierarchy' (console thread only)
+static CompressedGraph compressed;                  // Varint-compressed adjacency (console thread only)
+static uint64_t landmarksTried = 0;                 // Fingerprint FILELANDMARKS was last tried for
+static uint64_t hubLabelsTried = 0;                 // Fingerprint FILEHUBLABELS was last tried for
 
 // -------------------------------------------------------------
 // Reset all runtime visualization states (colors, flags)
-// Does NOT delete any data, only restores neutral visual state
+// Does NOT delete any data, only drops the render overlay
 // -------------------------------------------------------------
-void cleanWorkspace(vector<Point>& points, vector<Line>& lines) {
-	for (auto& l : lines) {
-		l.setIsInPath(false);
-	}
-	for (auto& p : points) {
-		if (p.getIsStartPoint() || p.getIsEndPoint()) continue;
-		p.setColor(sf::Color(210, 210, 210), true);
-	}
+void cleanWorkspace(VisualState& visual) {
+	lock_guard<mutex> lock(visual.getMutex());
+	visual.clear();
 }
 
 // -------------------------------------------------------------
 // Delete point by name, also removes all connected lines
 // Returns true if a point was removed, false otherwise
 // -------------------------------------------------------------
-bool deletePointByName(const string& name, vector<Point>& points, vector<Line>& lines) {
-	auto it = remove_if(points.begin(), points.end(),
-		[&name](const Point& p) { return p.getName() == name; });
-
-	if (it != points.end()) {
-
-		// Remove all lines that touch this point
-		lines.erase(remove_if(lines.begin(), lines.end(),
-			[&name](const Line& l) {
-				return l.getStart().getName() == name || l.getEnd().getName() == name;
-			}), lines.end());
+bool deletePointByName(const string& name, GraphStorage& graph) {
+	uint32_t id = graph.findPoint(name);
+	if (id == INVALID_POINT_ID) return false;
 
-		points.erase(it, points.end());
-		return true;
-	}
-	return false;
+	return graph.removePoint(id);
 }
 
 // -------------------------------------------------------------
 // Delete a line defined by two point names
 // -------------------------------------------------------------
-void deleteLineByPoints(const string& startName, const string& endName, vector<Line>& lines) {
-	auto it = remove_if(lines.begin(), lines.end(),
-		[&startName, &endName](const Line& l) {
-			return (l.getStart().getName() == startName && l.getEnd().getName() == endName) ||
-				(l.getStart().getName() == endName && l.getEnd().getName() == startName);
-		});
-	if (it != lines.end()) {
-		lines.erase(it, lines.end());
-	}
+void deleteLineByPoints(const string& startName, const string& endName, GraphStorage& graph) {
+	uint32_t start = graph.findPoint(startName);
+	uint32_t end = graph.findPoint(endName);
+	if (start == INVALID_POINT_ID || end == INVALID_POINT_ID) return;
+
+	graph.removeLine(start, end);
 }
 
+// -------------------------------------------------------------
+// Current version as the index builders take it: the adjacency
+// weighted by the selected profile (the first one if that is not
+// loaded) and its weight fingerprint
+// -------------------------------------------------------------
+struct WeightedVersion {
+	shared_ptr<const GraphVersion> version;
+	size_t profile;
+	uint64_t fingerprint;
+	AdjacencyGraph adjacency;
+	ProfileGraph<AdjacencyGraph> weighted;
+
+	WeightedVersion(shared_ptr<const GraphVersion> current, const string& profileName)
+		: version(move(current)),
+		  profile(version->getProfiles().find(profileName) == INVALID_PROFILE ? 0 : version->getProfiles().find(profileName)),
+		  fingerprint(weightFingerprint(version->getLines(), version->getProfiles(), profile)),
+		  adjacency(version->getPoints(), version->getLines(), 1.0, &version->getProfiles()),
+		  weighted(adjacency, profile) {}
+
+	WeightedVersion(const WeightedVersion&) = delete;
+	WeightedVersion& operator=(const WeightedVersion&) = delete;
+};
+
 // -------------------------------------------------------------
 // Main console interface loop (runs in separate thread)
 // Handles user input, data modification, and file I/O
 // All operations touching shared state are mutex-protected
 // -------------------------------------------------------------
-void MainInterface(std::vector<Point>& points, std::vector<Line>& lines)
+void MainInterface(GraphStorage& graph, VisualState& visual)
 {
 	while (isRunning) {
 		cout << "\n------- Menu -------\n";
@@ -97,6 +119,16 @@ void MainInterface(std::vector<Point>& points, std::vector<Line>& lines)
 		cout << " - 10. Delete line\n";
 		cout << "-------------------\n";
 		cout << " - 11. Find shortest path\n";
+		cout << " - 12. Benchmark queries\n";
+		cout << " - 14. Save binary snapshot\n";
+		cout << " - 15. Query binary snapshot\n";
+		cout << " - 16. Prepare ALT landmarks\n";
+		cout << " - 17. Prepare contraction hierarchy\n";
+		cout << " - 18. Prepare customizable hierarchy (CCH)\n";
+		cout << " - 19. Prepare hub labels\n";
+		cout << " - 20. Prepare arc flags\n";
+		cout << " - 21. Prepare transit node routing\n";
+		cout << " - 22. Prepare compressed adjacency\n";
 		cout << "-------------------\n";
 		cout << " - 0.  Exit console loop\n";
 		cout << " - 13. Settings\n";
@@ -125,10 +157,12 @@ void MainInterface(std::vector<Point>& points, std::vector<Line>& lines)
 			string filename;
 			cin >> filename;
 
-			if (loadPointsFromFile(filename, points, lines))
+			cleanWorkspace(visual);
+			if (loadPointsFromFile(filename, graph))
 				cout << "Points loaded successfully.\n";
 			else
 				cout << "Failed to load points.\n";
+			graph.publish();
 			break;
 		}
 		case 2: {
@@ -140,24 +174,27 @@ void MainInterface(std::vector<Point>& points, std::vector<Line>& lines)
 			string filename;
 			cin >> filename;
 
-			if (loadLinesFromFile(filename, lines, points))
+			cleanWorkspace(visual);
+			if (loadLinesFromFile(filename, graph))
 				cout << "Lines loaded successfully.\n";
 			else
 				cout << "Failed to load lines.\n";
+			graph.publish();
 			break;
 		}
 
 			  // ---------------------- ADD POINT ----------------------
 		case 3: {
 			lock_guard<mutex> lock(dataMutex);
-			cleanWorkspace(points, lines);
+			cleanWorkspace(visual);
 
 			Point newPoint(0.0, 0.0, "");
 			cout << "Enter point x y name: ";
 			cin >> newPoint;
 
-			if (validateNewPoint(newPoint, points)) {
-				points.push_back(newPoint);
+			if (validateNewPoint(newPoint, graph)) {
+				graph.addPoint(newPoint);
+				graph.publish();
 				cout << "Point added successfully.\n";
 			}
 			break;
@@ -166,30 +203,32 @@ void MainInterface(std::vector<Point>& points, std::vector<Line>& lines)
 			  // ---------------------- ADD LINE ----------------------
 		case 4: {
 			lock_guard<mutex> lock(dataMutex);
-			cleanWorkspace(points, lines);
+			cleanWorkspace(visual);
 
 			double weight;
-			cout << "Enter start point name, end point name and weight: ";
+			bool directed = false;
+			cout << "Enter start point name, end point name, weight (add " << LINE_ONE_WAY << " for one-way): ";
 
 			string startName, endName;
-			cin >> startName >> endName >> weight;
+			if (!(cin >> startName >> endName >> weight) || !readLineDirection(cin, directed)) {
+				cin.clear();
+				cin.ignore(numeric_limits<streamsize>::max(), '\n');
+				cout << "Line Error: Format Error\n";
+				break;
+			}
 
 			// Validation handles duplicates and illegal values
-			if (!validateNewLine(startName, endName, weight, lines, points)) {
+			if (!validateNewLine(startName, endName, weight, graph, directed)) {
 				break;
 			}
 
-			Point* start = nullptr;
-			Point* end = nullptr;
-
-			// Find pointers to points
-			for (auto& p : points) {
-				if (p.getName() == startName) start = &p;
-				if (p.getName() == endName) end = &p;
-			}
+			// Resolve names to point ids
+			uint32_t start = graph.findPoint(startName);
+			uint32_t end = graph.findPoint(endName);
 
-			if (start && end) {
-				lines.emplace_back(*start, *end, weight);
+			if (start != INVALID_POINT_ID && end != INVALID_POINT_ID) {
+				graph.addLine(start, end, weight, directed);
+				graph.publish();
 				cout << "Line added successfully.\n";
 			}
 			else {
@@ -201,50 +240,44 @@ void MainInterface(std::vector<Point>& points, std::vector<Line>& lines)
 			  // ---------------------- FLAG START ----------------------
 		case 5: {
 			lock_guard<mutex> lock(dataMutex);
-			cleanWorkspace(points, lines);
+			cleanWorkspace(visual);
 			cout << "Enter start point name: ";
 
 			string startName;
 			cin >> startName;
 
 			// Reset flags
-			for (auto& p : points) p.setIsStartPoint(false);
-
-			bool found = false;
-			for (auto& p : points) {
-				if (p.getName() == startName) {
-					p.setIsStartPoint(true);
-					cout << "Start point flagged successfully.\n";
-					found = true;
-					break;
-				}
+			for (auto p : graph.editPoints()) p.setIsStartPoint(false);
+
+			uint32_t id = graph.findPoint(startName);
+			if (id != INVALID_POINT_ID) {
+				graph.getPoint(id).setIsStartPoint(true);
+				cout << "Start point flagged successfully.\n";
 			}
-			if (!found) cout << "No such point found.\n";
+			else cout << "No such point found.\n";
+			graph.publish();
 			break;
 		}
 
 			  // ---------------------- FLAG END ----------------------
 		case 6: {
 			lock_guard<mutex> lock(dataMutex);
-			cleanWorkspace(points, lines);
+			cleanWorkspace(visual);
 			cout << "Enter end point name: ";
 
 			string endName;
 			cin >> endName;
 
 			// Reset flags
-			for (auto& p : points) p.setIsEndPoint(false);
-
-			bool found = false;
-			for (auto& p : points) {
-				if (p.getName() == endName) {
-					p.setIsEndPoint(true);
-					cout << "End point flagged successfully.\n";
-					found = true;
-					break;
-				}
+			for (auto p : graph.editPoints()) p.setIsEndPoint(false);
+
+			uint32_t id = graph.findPoint(endName);
+			if (id != INVALID_POINT_ID) {
+				graph.getPoint(id).setIsEndPoint(true);
+				cout << "End point flagged successfully.\n";
 			}
-			if (!found) cout << "No such point found.\n";
+			else cout << "No such point found.\n";
+			graph.publish();
 			break;
 		}
 
@@ -253,7 +286,7 @@ void MainInterface(std::vector<Point>& points, std::vector<Line>& lines)
 			lock_guard<mutex> lock(dataMutex);
 			cout << "Name\tx\ty\n";
 			cout << "-------------------\n";
-			for (const auto& p : points) cout << p << "\n";
+			for (const auto& p : graph.getPoints()) cout << p << "\n";
 			break;
 		}
 
@@ -262,21 +295,27 @@ void MainInterface(std::vector<Point>& points, std::vector<Line>& lines)
 			lock_guard<mutex> lock(dataMutex);
 			cout << "Start\t->\tEnd\tWeight\n";
 			cout << "-------------------\n";
-			for (const auto& l : lines) cout << l << "\n";
+			const PointStore& points = graph.getPoints();
+			for (const auto& l : graph.getLines()) {
+				printLine(cout, l, points);
+				cout << "\n";
+			}
 			break;
 		}
 
 			  // ---------------------- DELETE POINT ----------------------
 		case 9: {
 			lock_guard<mutex> lock(dataMutex);
-			cleanWorkspace(points, lines);
+			cleanWorkspace(visual);
 
 			cout << "Enter point name to delete: ";
 			string pointName;
 			cin >> pointName;
 
-			if (deletePointByName(pointName, points, lines))
+			if (deletePointByName(pointName, graph)) {
+				graph.publish();
 				cout << "Point and connected lines deleted.\n";
+			}
 			else
 				cout << "No such point.\n";
 			break;
@@ -285,24 +324,70 @@ void MainInterface(std::vector<Point>& points, std::vector<Line>& lines)
 			  // ---------------------- DELETE LINE ----------------------
 		case 10: {
 			lock_guard<mutex> lock(dataMutex);
-			cleanWorkspace(points, lines);
+			cleanWorkspace(visual);
 
 			cout << "Enter start and end point names for line deletion: ";
 
 			string startName, endName;
 			cin >> startName >> endName;
 
-			deleteLineByPoints(startName, endName, lines);
+			deleteLineByPoints(startName, endName, graph);
+			graph.publish();
 			cout << "Line deleted (if it existed).\n";
 			break;
 		}
 
 			   // ---------------------- DIJKSTRA ----------------------
 		case 11: {
-			cleanWorkspace(points, lines);
+			cleanWorkspace(visual);
 
+			// Runs on the current version; later edits do not affect it
 			cout << "Finding shortest path...\n";
-			auto [s, p] = findShortestPath(points, lines);
+			shared_ptr<const GraphVersion> version = graph.current();
+			size_t profile = version->getProfiles().find(weightProfile);
+			if (profile == INVALID_PROFILE) {
+				cout << "Weight profile '" << weightProfile << "' not loaded, using '" << version->getProfiles().getName(0) << "'.\n";
+				profile = 0;
+			}
+
+			// Reuse the stored landmark tables and hub labels if they belong to this
+			// graph. Each file is tried once per fingerprint, and replaces the index
+			// in memory only if it matches.
+			uint64_t fingerprint = weightFingerprint(version->getLines(), version->getProfiles(), profile);
+			if (searchMode == SEARCH_ALT && landmarks.getFingerprint() != fingerprint && landmarksTried != fingerprint) {
+				landmarksTried = fingerprint;
+				LandmarkTable stored;
+				if (stored.load(FILELANDMARKS) && stored.getFingerprint() == fingerprint) landmarks = move(stored);
+			}
+			if (searchMode == SEARCH_HUB_LABELS && hubLabels.getFingerprint() != fingerprint && hubLabelsTried != fingerprint) {
+				hubLabelsTried = fingerprint;
+				// Mapping is cheap: check the file first, then map it again in place
+				HubLabels stored;
+				if (stored.open(FILEHUBLABELS) && stored.getFingerprint() == fingerprint) {
+					stored.close();
+					hubLabels.open(FILEHUBLABELS);
+				}
+			}
+
+			// Weights changed since the last customization: re-apply them (the order stays)
+			if (searchMode == SEARCH_CCH && !customizable.empty() && customizable.getFingerprint() != fingerprint) {
+				auto begin = chrono::steady_clock::now();
+				AdjacencyGraph adjacency(version->getPoints(), version->getLines(), 1.0, &version->getProfiles());
+				if (customizable.customize(ProfileGraph<AdjacencyGraph>(adjacency, profile), fingerprint)) {
+					cout << "Customized CCH in " << chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count() << " ms\n";
+				}
+			}
+
+			QueryIndexes indexes;
+			indexes.fingerprint = fingerprint;
+			indexes.landmarks = &landmarks;
+			indexes.hierarchy = &hierarchy;
+			indexes.customizable = &customizable;
+			indexes.hubLabels = &hubLabels;
+			indexes.arcFlags = &arcFlags;
+			indexes.transitNodes = &transitNodes;
+			indexes.compressed = &compressed;
+			auto [s, p] = findShortestPath(*version, visual, profile, searchMode, indexes);
 
 			if (p == 0) {
 				cout << "No path found.\n";
@@ -310,7 +395,209 @@ void MainInterface(std::vector<Point>& points, std::vector<Line>& lines)
 			}
 
 			cout << "Shortest path: " << s << "\n";
-			cout << "Total weight: " << p << "\n";
+			cout << "Total weight: " << p;
+			if (version->getProfiles().count() > 1) cout << " (" << version->getProfiles().getName(profile) << ")";
+			cout << "\n";
+			break;
+		}
+
+			   // ---------------------- BENCHMARK ----------------------
+		case 12: {
+			cout << "Enter number of random queries: ";
+
+			size_t queryCount;
+			if (!(cin >> queryCount)) {
+				cin.clear();
+				cin.ignore(numeric_limits<streamsize>::max(), '\n');
+				cout << "Invalid number.\n";
+				break;
+			}
+
+			runQueryBenchmark(*graph.current(), queryCount);
+			break;
+		}
+
+			   // ---------------------- SAVE SNAPSHOT ----------------------
+		case 14: {
+			lock_guard<mutex> lock(dataMutex);
+			cout << "Enter snapshot filename (e.g. " << FILESNAPSHOT << "): ";
+
+			string filename;
+			cin >> filename;
+
+			if (saveGraphSnapshot(filename, graph))
+				cout << "Snapshot saved successfully.\n";
+			else
+				cout << "Failed to save snapshot.\n";
+			break;
+		}
+
+			   // ---------------------- QUERY SNAPSHOT ----------------------
+		case 15: {
+			// Works on the mapped file only, the loaded graph is not touched
+			cout << "Enter snapshot filename (e.g. " << FILESNAPSHOT << "): ";
+
+			string filename;
+			cin >> filename;
+
+			auto begin = chrono::steady_clock::now();
+			GraphSnapshot snapshot;
+			if (!snapshot.open(filename)) {
+				cout << "Failed to open snapshot.\n";
+				break;
+			}
+			auto end = chrono::steady_clock::now();
+
+			cout << "Mapped " << snapshot.nodeCount() << " points / " << snapshot.arcCount() << " arcs ("
+				<< snapshot.mappedBytes() / 1024 << " KB) in "
+				<< chrono::duration<double, milli>(end - begin).count() << " ms\n";
+
+			cout << "Enter start and end point names: ";
+			string startName, endName;
+			cin >> startName >> endName;
+
+			uint32_t source = snapshot.findPoint(startName);
+			uint32_t target = snapshot.findPoint(endName);
+			if (source == INVALID_POINT_ID || target == INVALID_POINT_ID) {
+				cout << "No such point found.\n";
+				break;
+			}
+
+			DijkstraQuery<GraphSnapshot> query(snapshot);
+			auto result = query.run(source, target);
+			if (!result.found) {
+				cout << "No path found.\n";
+				break;
+			}
+
+			string pathStr;
+			for (uint32_t id : result.nodes) {
+				if (!pathStr.empty()) pathStr += "->";
+				pathStr += snapshot.getName(id);
+			}
+			cout << "Shortest path: " << pathStr << "\n";
+			cout << "Total weight: " << result.distance << "\n";
+			break;
+		}
+
+			   // ---------------------- ALT LANDMARKS ----------------------
+		case 16: {
+			// Built for the current version and weight profile, then stored
+			auto begin = chrono::steady_clock::now();
+			WeightedVersion current(graph.current(), weightProfile);
+			landmarks.build(current.weighted, LANDMARK_COUNT, current.fingerprint);
+			auto end = chrono::steady_clock::now();
+
+			cout << "Selected " << landmarks.count() << " landmarks ("
+				<< landmarks.memoryUsage() / 1024 << " KB) in "
+				<< chrono::duration<double, milli>(end - begin).count() << " ms\n";
+			if (landmarks.save(FILELANDMARKS))
+				cout << "Landmarks saved to " << FILELANDMARKS << ".\n";
+			break;
+		}
+
+			   // ---------------------- CONTRACTION HIERARCHY ----------------------
+		case 17: {
+			// Built for the current version and weight profile
+			auto begin = chrono::steady_clock::now();
+			WeightedVersion current(graph.current(), weightProfile);
+			hierarchy.build(current.weighted, current.fingerprint);
+			auto end = chrono::steady_clock::now();
+
+			cout << "Contracted " << hierarchy.nodeCount() << " points, " << hierarchy.shortcutCount() << " shortcuts ("
+				<< hierarchy.memoryUsage() / 1024 << " KB) in "
+				<< chrono::duration<double, milli>(end - begin).count() << " ms\n";
+			break;
+		}
+
+			   // ---------------------- CUSTOMIZABLE HIERARCHY ----------------------
+		case 18: {
+			// Order from coordinates and topology; the weights are customized
+			// again by the search whenever they change
+			auto begin = chrono::steady_clock::now();
+			WeightedVersion current(graph.current(), weightProfile);
+			customizable.prepare(current.version->getPoints(), current.weighted);
+			auto prepared = chrono::steady_clock::now();
+			if (!customizable.customize(current.weighted, current.fingerprint)) break;
+			auto end = chrono::steady_clock::now();
+
+			cout << "Ordered " << customizable.nodeCount() << " points, " << customizable.arcCount() << " arcs, "
+				<< customizable.levelCount() << " levels (" << customizable.memoryUsage() / 1024 << " KB) in "
+				<< chrono::duration<double, milli>(prepared - begin).count() << " ms, customized in "
+				<< chrono::duration<double, milli>(end - prepared).count() << " ms\n";
+			break;
+		}
+
+			   // ---------------------- HUB LABELS ----------------------
+		case 19: {
+			// Labels follow the contraction order, so the hierarchy is rebuilt if out of date
+			auto begin = chrono::steady_clock::now();
+			WeightedVersion current(graph.current(), weightProfile);
+			if (hierarchy.empty() || hierarchy.getFingerprint() != current.fingerprint) hierarchy.build(current.weighted, current.fingerprint);
+			auto ordered = chrono::steady_clock::now();
+			if (!hubLabels.build(current.weighted, hierarchy, current.fingerprint)) break;
+			auto end = chrono::steady_clock::now();
+
+			cout << "Labeled " << hubLabels.nodeCount() << " points, " << hubLabels.averageLabelSize() << " hubs per label ("
+				<< hubLabels.bytes() / 1024 << " KB) in " << chrono::duration<double, milli>(end - ordered).count()
+				<< " ms (CH order " << chrono::duration<double, milli>(ordered - begin).count() << " ms)\n";
+			if (hubLabels.save(FILEHUBLABELS))
+				cout << "Hub labels saved to " << FILEHUBLABELS << ".\n";
+			break;
+		}
+
+			   // ---------------------- ARC FLAGS ----------------------
+		case 20: {
+			// Cells from the coordinates, flags for the current version and weight profile
+			auto begin = chrono::steady_clock::now();
+			WeightedVersion current(graph.current(), weightProfile);
+			arcFlags.build(current.version->getPoints(), current.weighted, ARCFLAG_CELLS, current.fingerprint);
+			auto end = chrono::steady_clock::now();
+
+			cout << "Flagged " << arcFlags.cellCount() << " cells from " << arcFlags.boundaryCount() << " boundary points, "
+				<< arcFlags.flaggedShare() * 100 << "% of lines per cell (" << arcFlags.memoryUsage() / 1024 << " KB) in "
+				<< chrono::duration<double, milli>(end - begin).count() << " ms\n";
+			break;
+		}
+
+			   // ---------------------- TRANSIT NODE ROUTING ----------------------
+		case 21: {
+			// Transit nodes are the top of the contraction order, so the hierarchy is rebuilt if out of date
+			auto begin = chrono::steady_clock::now();
+			WeightedVersion current(graph.current(), weightProfile);
+			if (hierarchy.empty() || hierarchy.getFingerprint() != current.fingerprint) hierarchy.build(current.weighted, current.fingerprint);
+			auto ordered = chrono::steady_clock::now();
+
+			const PointStore& points = current.version->getPoints();
+			vector<double> xs(hierarchy.nodeCount(), 0.0), ys(hierarchy.nodeCount(), 0.0);
+			for (auto it = points.begin(); it != points.end(); ++it) {
+				xs[it.slot()] = it->getX();
+				ys[it.slot()] = it->getY();
+			}
+			transitNodes.build(hierarchy, xs, ys);
+			auto end = chrono::steady_clock::now();
+
+			cout << "Selected " << transitNodes.transitCount() << " transit points, " << transitNodes.averageAccessCount()
+				<< " access points per point (" << transitNodes.memoryUsage() / 1024 << " KB) in "
+				<< chrono::duration<double, milli>(end - ordered).count() << " ms (CH order "
+				<< chrono::duration<double, milli>(ordered - begin).count() << " ms)\n";
+			break;
+		}
+
+			   // ---------------------- COMPRESSED ADJACENCY ----------------------
+		case 22: {
+			// Encoded from the lines of the current version, weighted by the current profile
+			auto begin = chrono::steady_clock::now();
+			shared_ptr<const GraphVersion> version = graph.current();
+			const WeightProfiles& profiles = version->getProfiles();
+			size_t profile = profiles.find(weightProfile) == INVALID_PROFILE ? 0 : profiles.find(weightProfile);
+			compressed.build(version->getPoints().capacity(), edgeRecords(version->getLines(), &profiles, profile),
+				weightFingerprint(version->getLines(), profiles, profile));
+			auto end = chrono::steady_clock::now();
+
+			cout << "Encoded " << compressed.nodeCount() << " points, " << compressed.arcCount() << " arcs ("
+				<< compressed.memoryUsage() / 1024 << " KB) in "
+				<< chrono::duration<double, milli>(end - begin).count() << " ms\n";
 			break;
 		}
 
@@ -329,6 +616,8 @@ void MainInterface(std::vector<Point>& points, std::vector<Line>& lines)
 			cout << " - 1. Toggle point labels display\n";
 			cout << " - 2. Toggle edge weights display\n";
 			cout << " - 3. Set animation delay (current: " << ANIMATION_DELAY << " ms)\n";
+			cout << " - 4. Select weight profile (current: " << weightProfile << ")\n";
+			cout << " - 5. Select search mode (current: " << searchModeName(searchMode) << ")\n";
 			cout << "Enter command: ";
 
 			int settingCommand;
@@ -352,6 +641,40 @@ void MainInterface(std::vector<Point>& points, std::vector<Line>& lines)
 				cout << "Animation delay set to " << ANIMATION_DELAY << " ms.\n";
 				break;
 
+			case 4: {
+				const WeightProfiles& profiles = graph.getProfiles();
+				cout << "Loaded profiles:";
+				for (size_t i = 0; i < profiles.count(); i++) cout << " " << profiles.getName(i);
+				cout << "\nEnter profile name: ";
+
+				string name;
+				cin >> name;
+				if (profiles.find(name) == INVALID_PROFILE) {
+					cout << "Unknown weight profile.\n";
+					break;
+				}
+				weightProfile = name;
+				cout << "Weight profile set to " << weightProfile << ".\n";
+				break;
+			}
+
+			case 5: {
+				for (int m = 0; m < SEARCH_MODE_COUNT; m++) {
+					cout << "   " << m + 1 << ". " << searchModeName(static_cast<SearchMode>(m)) << "\n";
+				}
+				cout << "Enter search mode: ";
+
+				int mode;
+				cin >> mode;
+				if (mode < 1 || mode > SEARCH_MODE_COUNT) {
+					cout << "Invalid search mode.\n";
+					break;
+				}
+				searchMode = static_cast<SearchMode>(mode - 1);
+				cout << "Search mode set to " << searchModeName(searchMode) << ".\n";
+				break;
+			}
+
 			default:
 				cout << "Invalid settings command.\n";
 			}
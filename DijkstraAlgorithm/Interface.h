@@ -6,14 +6,17 @@
 #include <vector>
 #include "Point.h"
 #include "Line.h"
+#include "GraphStorage.h"
+#include "VisualState.h"
 #include <mutex>
 #include <atomic>
 
 using namespace std;
 
 // ------------------------------------------------------------
-// Global synchronization mutex for safe access to shared data
-// Used by both the rendering thread and the console thread
+// Global mutex serializing edits of the graph
+// Readers (renderer, queries) do not take it: they work on the
+// immutable version published by GraphStorage after each edit
 // ------------------------------------------------------------
 extern mutex dataMutex;
 
@@ -29,6 +32,6 @@ extern int ANIMATION_DELAY;
 // ------------------------------------------------------------
 extern atomic<bool> isRunning;
 
-void MainInterface(vector<Point>& points, vector<Line>& lines);
+void MainInterface(GraphStorage& graph, VisualState& visual);
 
 #endif
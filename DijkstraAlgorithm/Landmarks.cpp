@@ -0,0 +1,220 @@
+#include "Landmarks.h"
+#include "ParallelFor.h"
+#include <queue>
+#include <limits>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+
+template <typename GraphType>
+void LandmarkTable::distances(const GraphType& graph, uint32_t source, bool reverse, vector<double>& dist)
+{
+    typedef typename GraphType::NodeType NodeId;
+    typedef typename GraphType::WeightType Weight;
+
+    dist.assign(graph.nodeCount(), numeric_limits<double>::infinity());
+
+    typedef pair<double, NodeId> Entry;
+    priority_queue<Entry, vector<Entry>, greater<Entry>> pq;
+    dist[source] = 0.0;
+    pq.push({ 0.0, source });
+
+    while (!pq.empty()) {
+        auto [d, u] = pq.top();
+        pq.pop();
+        if (d > dist[u]) continue;  // Skip outdated values
+
+        auto relax = [&](NodeId v, Weight weight, NodeId) {
+            double alt = d + static_cast<double>(weight);
+            if (alt < dist[v]) {
+                dist[v] = alt;
+                pq.push({ alt, v });
+            }
+        };
+        if (reverse) graph.forEachReverseArc(u, relax);
+        else graph.forEachArc(u, relax);
+    }
+}
+
+template <typename GraphType>
+void LandmarkTable::computeColumns(const GraphType& graph, const vector<uint32_t>& sources, bool reverse,
+    vector<vector<double>>& columns)
+{
+    columns.resize(sources.size());
+    unsigned threads = graph.arcCount() < PARALLEL_MIN_ITEMS ? 1 : static_cast<unsigned>(sources.size());
+    parallelChunks(sources.size(), threads, [&](unsigned, size_t begin, size_t end) {
+        for (size_t k = begin; k < end; k++) {
+            if (columns[k].empty()) distances(graph, sources[k], reverse, columns[k]);
+        }
+    });
+}
+
+void LandmarkTable::storeColumns(const vector<vector<double>>& from, const vector<vector<double>>& to)
+{
+    size_t count = landmarks.size();
+    fromLandmark.resize(nodes * count);
+    toLandmark.resize(to.empty() ? 0 : nodes * count);
+
+    for (size_t k = 0; k < count; k++) {
+        for (size_t v = 0; v < nodes; v++) {
+            fromLandmark[v * count + k] = from[k][v];
+            if (!to.empty()) toLandmark[v * count + k] = to[k][v];
+        }
+    }
+}
+
+template <typename GraphType>
+void LandmarkTable::build(const GraphType& graph, size_t count, uint64_t graphFingerprint)
+{
+    nodes = graph.nodeCount();
+    fingerprint = graphFingerprint;
+    landmarks.clear();
+
+    // Start the selection at any node with arcs
+    uint32_t seed = 0;
+    bool hasArcs = false;
+    for (uint32_t u = 0; u < nodes && !hasArcs; u++) {
+        graph.forEachArc(u, [&](auto, auto, auto) { hasArcs = true; });
+        if (hasArcs) seed = u;
+    }
+
+    vector<vector<double>> from, to;
+    if (hasArcs) {
+        // Farthest selection: the next landmark is the node farthest from
+        // all chosen ones (the first is the one farthest from the seed)
+        vector<double> nearest;
+        distances(graph, seed, false, nearest);
+
+        while (landmarks.size() < count) {
+            uint32_t farthest = 0;
+            double farthestDistance = 0.0;
+            for (uint32_t v = 0; v < nodes; v++) {
+                if (isfinite(nearest[v]) && nearest[v] > farthestDistance) {
+                    farthest = v;
+                    farthestDistance = nearest[v];
+                }
+            }
+            if (farthestDistance == 0.0) break;  // Every reachable node is a landmark
+
+            landmarks.push_back(farthest);
+            from.emplace_back();
+            distances(graph, farthest, false, from.back());
+
+            for (uint32_t v = 0; v < nodes; v++) {
+                nearest[v] = landmarks.size() == 1 ? from.back()[v] : min(nearest[v], from.back()[v]);
+            }
+        }
+
+        if (!graph.isSymmetric()) computeColumns(graph, landmarks, true, to);
+    }
+    storeColumns(from, to);
+}
+
+template <typename GraphType>
+void LandmarkTable::build(const GraphType& graph, const vector<uint32_t>& chosen, uint64_t graphFingerprint)
+{
+    nodes = graph.nodeCount();
+    fingerprint = graphFingerprint;
+    landmarks = chosen;
+
+    vector<vector<double>> from, to;
+    computeColumns(graph, landmarks, false, from);
+    if (!graph.isSymmetric()) computeColumns(graph, landmarks, true, to);
+    storeColumns(from, to);
+}
+
+double LandmarkTable::lowerBound(uint32_t v, uint32_t t) const
+{
+    if (v >= nodes || t >= nodes || landmarks.empty()) return 0.0;
+
+    size_t count = landmarks.size();
+    const double* fromV = &fromLandmark[v * count];
+    const double* fromT = &fromLandmark[t * count];
+    const double* toV = toLandmark.empty() ? fromV : &toLandmark[v * count];
+    const double* toT = toLandmark.empty() ? fromT : &toLandmark[t * count];
+
+    // Largest triangle-inequality bound over all landmarks
+    // (unreachable pairs give no bound)
+    double bound = 0.0;
+    for (size_t k = 0; k < count; k++) {
+        if (isfinite(fromT[k]) && isfinite(fromV[k])) bound = max(bound, fromT[k] - fromV[k]);
+        if (isfinite(toV[k]) && isfinite(toT[k])) bound = max(bound, toV[k] - toT[k]);
+    }
+    return bound;
+}
+
+bool LandmarkTable::save(const string& filename) const
+{
+    ofstream out(filename, ios::binary | ios::trunc);
+    if (!out.is_open()) {
+        cout << "Landmark Error: Cannot create file (" << filename << ")" << endl;
+        return false;
+    }
+
+    LandmarkHeader header = {};
+    memcpy(header.magic, LANDMARK_MAGIC, sizeof(LANDMARK_MAGIC));
+    header.version = LANDMARK_VERSION;
+    header.count = static_cast<uint32_t>(landmarks.size());
+    header.nodeCount = nodes;
+    header.fingerprint = fingerprint;
+    header.symmetric = toLandmark.empty() ? 1 : 0;
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(landmarks.data()), landmarks.size() * sizeof(uint32_t));
+    out.write(reinterpret_cast<const char*>(fromLandmark.data()), fromLandmark.size() * sizeof(double));
+    out.write(reinterpret_cast<const char*>(toLandmark.data()), toLandmark.size() * sizeof(double));
+
+    if (!out.good()) {
+        cout << "Landmark Error: Write failed (" << filename << ")" << endl;
+        return false;
+    }
+    return true;
+}
+
+bool LandmarkTable::load(const string& filename)
+{
+    ifstream in(filename, ios::binary);
+    if (!in.is_open()) return false;
+
+    LandmarkHeader header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))
+        || memcmp(header.magic, LANDMARK_MAGIC, sizeof(LANDMARK_MAGIC)) != 0 || header.version != LANDMARK_VERSION) {
+        cout << "Landmark Error: Not a landmark file (" << filename << ")" << endl;
+        return false;
+    }
+
+    // The tables must fill the rest of the file exactly
+    uint64_t tables = header.nodeCount * header.count * (header.symmetric ? 1 : 2);
+    streamoff position = in.tellg();
+    in.seekg(0, ios::end);
+    if (static_cast<uint64_t>(in.tellg() - position) != header.count * sizeof(uint32_t) + tables * sizeof(double)) {
+        cout << "Landmark Error: File size does not match its header (" << filename << ")" << endl;
+        return false;
+    }
+    in.seekg(position);
+
+    vector<uint32_t> newLandmarks(header.count);
+    vector<double> newFrom(header.nodeCount * header.count);
+    vector<double> newTo(header.symmetric ? 0 : header.nodeCount * header.count);
+    in.read(reinterpret_cast<char*>(newLandmarks.data()), newLandmarks.size() * sizeof(uint32_t));
+    in.read(reinterpret_cast<char*>(newFrom.data()), newFrom.size() * sizeof(double));
+    in.read(reinterpret_cast<char*>(newTo.data()), newTo.size() * sizeof(double));
+    if (!in) {
+        cout << "Landmark Error: Read failed (" << filename << ")" << endl;
+        return false;
+    }
+
+    landmarks = move(newLandmarks);
+    fromLandmark = move(newFrom);
+    toLandmark = move(newTo);
+    nodes = header.nodeCount;
+    fingerprint = header.fingerprint;
+    return true;
+}
+
+template void LandmarkTable::build(const Graph<size_t, double>&, size_t, uint64_t);
+template void LandmarkTable::build(const ProfileGraph<Graph<size_t, double>>&, size_t, uint64_t);
+template void LandmarkTable::build(const Graph<size_t, double>&, const vector<uint32_t>&, uint64_t);
+template void LandmarkTable::build(const ProfileGraph<Graph<size_t, double>>&, const vector<uint32_t>&, uint64_t);
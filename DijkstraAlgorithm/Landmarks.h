@@ -0,0 +1,117 @@
+#pragma once
+
+#ifndef LANDMARKS_H
+#define LANDMARKS_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include "Graph.h"
+#include "WeightProfiles.h"
+
+using namespace std;
+
+// Number of landmarks selected by default
+#define LANDMARK_COUNT 8
+
+// Landmark table file layout
+#define LANDMARK_MAGIC "DJKLMRK"
+#define LANDMARK_VERSION 1
+
+struct LandmarkHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t count;         // Number of landmarks
+    uint64_t nodeCount;
+    uint64_t fingerprint;   // weightFingerprint() of the graph the tables belong to
+    uint32_t symmetric;     // 1 if only the 'from' table is stored
+    uint32_t reserved;
+};
+
+// ------------------------------------------------------------
+// ALT preprocessing: exact distances between a few landmark nodes
+// and every node, in both directions. By the triangle inequality
+//   d(v, t) >= d(L, t) - d(L, v)   and   d(v, t) >= d(v, L) - d(t, L)
+// for every landmark L, so the largest of these bounds is a
+// consistent A* potential for any metric, also where straight-line
+// distance says little (e.g. travel times).
+// Landmarks are picked by farthest selection: each new one is the
+// node farthest from those chosen so far, which spreads them over
+// the border of the graph where the bounds are tightest.
+// Distances are stored node-major ([v * count + k]), so a potential
+// evaluation reads one contiguous block per node.
+// Node ids are those of the graph the table was built on.
+// ------------------------------------------------------------
+class LandmarkTable
+{
+private:
+    vector<uint32_t> landmarks;
+    size_t nodes = 0;
+    vector<double> fromLandmark;    // d(landmark k, v)
+    vector<double> toLandmark;      // d(v, landmark k); empty for symmetric graphs
+    uint64_t fingerprint = 0;
+
+    // Distances from (or, reverse, to) one node to all nodes
+    template <typename GraphType>
+    static void distances(const GraphType& graph, uint32_t source, bool reverse, vector<double>& dist);
+
+    // Computes the missing distance columns, one thread per landmark
+    template <typename GraphType>
+    static void computeColumns(const GraphType& graph, const vector<uint32_t>& sources, bool reverse, vector<vector<double>>& columns);
+
+    // Interleaves per-landmark columns into the node-major tables
+    void storeColumns(const vector<vector<double>>& from, const vector<vector<double>>& to);
+
+public:
+    LandmarkTable() {}
+
+    // Selects 'count' landmarks by farthest selection and computes their tables.
+    // Selection needs the forward distances one after another; the reverse
+    // tables of a directed graph are then computed with one thread per landmark.
+    template <typename GraphType>
+    void build(const GraphType& graph, size_t count, uint64_t graphFingerprint);
+
+    // Computes the tables for given landmarks, one thread per landmark
+    template <typename GraphType>
+    void build(const GraphType& graph, const vector<uint32_t>& chosen, uint64_t graphFingerprint);
+
+    bool empty() const { return landmarks.empty(); }
+    size_t count() const { return landmarks.size(); }
+    size_t nodeCount() const { return nodes; }
+    uint64_t getFingerprint() const { return fingerprint; }
+    const vector<uint32_t>& getLandmarks() const { return landmarks; }
+
+    // Lower bound of the distance from v to t (0 if the table knows neither)
+    double lowerBound(uint32_t v, uint32_t t) const;
+
+    // Bytes used by the distance tables
+    size_t memoryUsage() const { return (fromLandmark.size() + toLandmark.size()) * sizeof(double); }
+
+    // Stores / restores the tables, so they are not recomputed per run
+    bool save(const string& filename) const;
+    bool load(const string& filename);
+};
+
+// ------------------------------------------------------------
+// A* potential from a landmark table (see AStarQuery)
+// ------------------------------------------------------------
+class LandmarkPotential
+{
+private:
+    const LandmarkTable& table;
+    uint32_t target = 0;
+
+public:
+    explicit LandmarkPotential(const LandmarkTable& table) : table(table) {}
+
+    void setTarget(uint32_t t) { target = t; }
+    double operator()(uint32_t v) const { return table.lowerBound(v, target); }
+};
+
+extern template void LandmarkTable::build(const Graph<size_t, double>&, size_t, uint64_t);
+extern template void LandmarkTable::build(const ProfileGraph<Graph<size_t, double>>&, size_t, uint64_t);
+extern template void LandmarkTable::build(const Graph<size_t, double>&, const vector<uint32_t>&, uint64_t);
+extern template void LandmarkTable::build(const ProfileGraph<Graph<size_t, double>>&, const vector<uint32_t>&, uint64_t);
+
+#endif
@@ -1,8 +1,10 @@
 #pragma once
 #include <SFML/Graphics.hpp>
 #include "Point.h"
+#include "PointStore.h"
+#include "SlotMap.h"
 
-// Default colors for different line states
+// Default colors for different line states (applied through VisualState)
 #define BASE_COLOR_LINE sf::Color(110, 110, 110)
 #define ACTIVE_COLOR_LINE sf::Color(100, 150, 255)
 #define ACCEPT_COLOR_LINE sf::Color(80, 220, 120)
@@ -10,6 +12,9 @@
 #define IS_PATH_COLOR_LINE sf::Color::Red
 #define POSSIBLE_SOLUTION_COLOR_LINE sf::Color::Blue
 
+// Id returned when no line matches a lookup
+#define INVALID_LINE_ID UINT32_MAX
+
 // Default thickness values for different states
 #define BASE_BOLDNESS_LINE 2
 #define ACTIVE_BOLDNESS_LINE 3
@@ -18,49 +23,43 @@
 class Line
 {
 private:
-    // References to the start and end points of the line.
-    const Point& start;
-    const Point& end;
+    // Handles to the start and end points of the line.
+    // Handles stay valid when other points are added or removed; the line
+    // does not point at a particular store, so graph versions can share it.
+    PointHandle start;
+    PointHandle end;
     double weight; // Weight of the edge (used in algorithms such as Dijkstra)
-
-    sf::Color color; // Current color of the line (depends on algorithm visualization state)
-    double boldness; // Visual thickness of the line when rendered
-
-    bool isInPath; // Indicates if the line is part of the final path solution
+    bool directed; // One-way from start to end; otherwise usable in both directions
 
 public:
-    // Constructor: creates a line between two points with a specific weight
-    Line(const Point& start, const Point& end, double weight);
+    // Constructor: creates a line between two stored points with a specific weight
+    Line(PointHandle start, PointHandle end, double weight, bool directed = false);
 
-    // Getters
-    const Point& getStart() const { return start; }
-    const Point& getEnd() const { return end; }
+    // Getters (endpoints are resolved in the store holding them)
+    PointView getStart(const PointStore& points) const { return points.get(start); }
+    PointView getEnd(const PointStore& points) const { return points.get(end); }
+    PointHandle getStartHandle() const { return start; }
+    PointHandle getEndHandle() const { return end; }
+    uint32_t getStartId() const { return start.index; }
+    uint32_t getEndId() const { return end.index; }
     double getWeight() const { return weight; }
-    sf::Color getColor() const { return color; }
-    double getBoldness() const { return boldness; }
-    bool getIsInPath() const { return isInPath; }
+    bool isDirected() const { return directed; }
 
     // Setters
     void setWeight(double w) { weight = w; }
 
-    // Updates the line color; if 'change' is false, resets to base color
-    void setColor(const sf::Color& newColor = BASE_COLOR_LINE, bool change = false);
-
-    // Updates line thickness; if 'change' is false, resets to base thickness
-    void setBoldness(double b = BASE_BOLDNESS_LINE, bool change = false);
-
-    // Marks the line as part of the resulting shortest path
-    void setIsInPath(bool inPath);
-
     // Calculates the geometric pixel length of the line
-    double calculateLength() const;
-
-    // Assignment operator (copies line visual/weight data but keeps references to the same points)
-    Line& operator=(const Line& other);
+    double calculateLength(const PointStore& points) const;
 
-    // Output operator for saving the line to a file or printing it
-    friend ostream& operator<<(ostream& os, const Line& line);
+    // Prints the line with its endpoint names for saving to a file or listing it
+    friend void printLine(ostream& os, const Line& line, const PointStore& points);
 
-    // Compares two lines by their endpoints and weight
+    // Compares two lines by their endpoints, weight and direction
     friend bool operator==(const Line& l1, const Line& l2);
 };
+
+void printLine(ostream& os, const Line& line, const PointStore& points);
+
+// Stable storage for lines; slot indices double as line ids
+typedef SlotHandle LineHandle;
+typedef SlotMap<Line> LineStore;
@@ -0,0 +1,59 @@
+#pragma once
+
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+using namespace std;
+
+// ------------------------------------------------------------
+// Section layout helpers of the binary image formats (graph
+// snapshot, hub labels): every array starts at an aligned byte
+// offset from the start of the image
+// ------------------------------------------------------------
+
+// Rounds an offset up to the section alignment
+inline uint64_t alignOffset(uint64_t offset, uint64_t alignment)
+{
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+// True if a section of 'bytes' at 'offset' is aligned and lies inside an image of 'size' bytes
+inline bool sectionFits(uint64_t offset, uint64_t bytes, size_t size, uint64_t alignment)
+{
+    return offset % alignment == 0 && offset <= size && bytes <= size - offset;
+}
+
+// ------------------------------------------------------------
+// Whole file mapped read-only (Win32 file mapping or POSIX mmap).
+// The bytes stay valid until close(); processes mapping the same
+// file share its pages.
+// ------------------------------------------------------------
+class MappedFile
+{
+private:
+    const uint8_t* bytes = nullptr;
+    size_t length = 0;
+    void* fileHandle = nullptr;     // Windows file and mapping handles
+    void* mappingHandle = nullptr;
+
+public:
+    MappedFile() = default;
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Maps the file; returns false (and stays closed) if it is missing or empty
+    bool open(const string& filename);
+    void close();
+
+    bool isOpen() const { return bytes != nullptr; }
+    const uint8_t* data() const { return bytes; }
+    size_t size() const { return length; }
+};
+
+#endif
@@ -1,6 +1,7 @@
 #include <iostream>
 #include "Point.h"
 #include "Line.h"
+#include "PointStore.h"
 
 using namespace std;
 
@@ -11,17 +12,23 @@ ostream& operator<<(ostream& os, const Point& point)
     return os;
 }
 
+// Output operator for a point stored in a PointStore
+ostream& operator<<(ostream& os, PointView point)
+{
+    os << point.getName() << "\t" << point.getX() << "\t" << point.getY();
+    return os;
+}
+
 // Input operator for Point
 // Reads x, y, and name from input stream
 istream& operator>>(istream& in, Point& point)
 {
     double x, y;
-    string name;
 
-    if (in >> x >> y >> name) {
+    // The name is read straight into the point so its buffer is reused between reads
+    if (in >> x >> y >> point.name) {
         point.setX(x);
         point.setY(y);
-        point.setName(name);
     }
     return in;
 }
@@ -33,27 +40,15 @@ bool operator==(const Point& p1, const Point& p2)
     return ((p1.x == p2.x) && (p1.y == p2.y)) || (p1.name == p2.name);
 }
 
-// Output operator for Line
-ostream& operator<<(ostream& os, const Line& line)
+// Output for Line, endpoint names come from the store
+void printLine(ostream& os, const Line& line, const PointStore& points)
 {
-    os << line.start.getName() << "\t->\t" << line.end.getName() << " \t" << line.weight;
-    return os;
+    os << line.getStart(points).getName() << "\t->\t" << line.getEnd(points).getName() << " \t" << line.weight;
+    if (line.directed) os << "\tone-way";
 }
 
 // Equality operator for Line
 bool operator==(const Line& l1, const Line& l2)
 {
-    return (l1.start == l2.start) && (l1.end == l2.end) && (l1.weight == l2.weight);
-}
-
-// Copy-assignment operator for Line
-Line& Line::operator=(const Line& other)
-{
-    if (this != &other) {
-        weight = other.weight;
-        color = other.color;
-        boldness = other.boldness;
-        isInPath = other.isInPath;
-    }
-    return *this;
+    return (l1.getStartId() == l2.getStartId()) && (l1.getEndId() == l2.getEndId()) && (l1.weight == l2.weight) && (l1.directed == l2.directed);
 }
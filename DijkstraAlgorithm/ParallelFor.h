@@ -0,0 +1,81 @@
+#pragma once
+
+#ifndef PARALLELFOR_H
+#define PARALLELFOR_H
+
+#include <thread>
+#include <vector>
+#include <cstddef>
+
+using namespace std;
+
+// Below this many items work runs on the calling thread only
+#define PARALLEL_MIN_ITEMS 65536
+
+// ------------------------------------------------------------
+// Number of worker threads for 'items' units of work:
+// all cores for large inputs, one for small ones (starting
+// threads would cost more than the work itself)
+// ------------------------------------------------------------
+inline unsigned workerCount(size_t items)
+{
+    if (items < PARALLEL_MIN_ITEMS) return 1;
+    unsigned cores = thread::hardware_concurrency();
+    return cores == 0 ? 1 : cores;
+}
+
+// ------------------------------------------------------------
+// Splits [0, count) into 'threads' contiguous chunks and calls
+// f(chunk, begin, end) for each of them on its own thread
+// (chunk 0 on the calling thread). Every chunk is called, even
+// an empty one, and the split depends only on count and threads,
+// so passes over the same range see the same chunks.
+// ------------------------------------------------------------
+template <typename F>
+void parallelChunks(size_t count, unsigned threads, F&& f)
+{
+    if (threads <= 1) {
+        f(0u, size_t(0), count);
+        return;
+    }
+
+    vector<thread> workers;
+    workers.reserve(threads - 1);
+    for (unsigned t = 1; t < threads; t++) {
+        workers.emplace_back([&f, t, count, threads] { f(t, count * t / threads, count * (t + 1) / threads); });
+    }
+    f(0u, size_t(0), count / threads);
+    for (thread& w : workers) w.join();
+}
+
+// ------------------------------------------------------------
+// In-place inclusive prefix sum of 'values' on 'threads' threads:
+// chunk sums first, then every chunk adds the sum before it
+// ------------------------------------------------------------
+template <typename T>
+void parallelPrefixSum(vector<T>& values, unsigned threads)
+{
+    vector<T> chunkStart(threads, 0);
+    parallelChunks(values.size(), threads, [&](unsigned chunk, size_t begin, size_t end) {
+        T sum = 0;
+        for (size_t i = begin; i < end; i++) sum += values[i];
+        chunkStart[chunk] = sum;
+    });
+
+    T running = 0;
+    for (T& s : chunkStart) {
+        T sum = s;
+        s = running;
+        running += sum;
+    }
+
+    parallelChunks(values.size(), threads, [&](unsigned chunk, size_t begin, size_t end) {
+        T sum = chunkStart[chunk];
+        for (size_t i = begin; i < end; i++) {
+            sum += values[i];
+            values[i] = sum;
+        }
+    });
+}
+
+#endif
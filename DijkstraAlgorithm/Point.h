@@ -2,6 +2,7 @@
 #include <SFML/Graphics.hpp>
 #include <string>
 #include <iostream>
+#include <cstdint>
 
 using namespace std;
 
@@ -15,10 +16,44 @@ using namespace std;
 #define END_COLOR_POINT sf::Color::Red
 #define OUTLINE_COLOR_POINT sf::Color::Black
 
+// Id returned for points that are not stored in a graph
+#define INVALID_POINT_ID UINT32_MAX
+
 // Default visual sizes
 #define SIZE_POINT 10.0f
 #define OUTLINE_SIZE_POINT 3
 
+// ------------------------------------------------------------
+// Visual attributes of a point. Kept apart from the coordinates so
+// that PointStore can hold them in their own column.
+// ------------------------------------------------------------
+struct PointVisual
+{
+    sf::Color color; // Fill color of the point (changes during algorithm visualization)
+    sf::Color outlineColor; // Color of the outline around the point
+    double size; // Diameter of the point
+    double outlineSize; // Thickness of the outline
+    bool isStartPoint; // Indicates whether this point is the algorithm's start node
+    bool isEndPoint; // Indicates whether this point is the algorithm's end node
+
+    // Default look of a plain point
+    PointVisual();
+
+    // Updates the fill color; resets to base color if change=false
+    void setColor(const sf::Color& newColor = BASE_COLOR_POINT, bool change = false);
+
+    // Marks the point as the algorithm's start node
+    void setIsStartPoint(bool isStart);
+
+    // Marks the point as the algorithm's end node
+    void setIsEndPoint(bool isEnd);
+};
+
+// ------------------------------------------------------------
+// Standalone point record, used for input and when adding points.
+// Points stored in a graph live column-wise in PointStore and are
+// accessed through PointRef/PointView, which mirror this API.
+// ------------------------------------------------------------
 class Point
 {
 private:
@@ -27,12 +62,7 @@ private:
     double y;
 
     string name; // Unique name/label of the point
-    sf::Color color; // Fill color of the point (changes during algorithm visualization)
-    sf::Color outlineColor; // Color of the outline around the point
-    double size; // Diameter of the point
-    double outlineSize; // Thickness of the outline
-    bool isStartPoint; // Indicates whether this point is the algorithm's start node
-    bool isEndPoint; // Indicates whether this point is the algorithm's end node
+    PointVisual visual; // Colors, sizes and start/end flags
 
 public:
 
@@ -45,13 +75,14 @@ public:
     // Getters
     double getX() const { return x; }
     double getY() const { return y; }
-    string getName() const { return name; }
-    sf::Color getColor() const { return color; }
-    sf::Color getOutlineColor() const { return outlineColor; }
-    double getSize() const { return size; }
-    double getOutlineSize() const { return outlineSize; }
-    bool getIsStartPoint() const { return isStartPoint; }
-    bool getIsEndPoint() const { return isEndPoint; }
+    const string& getName() const { return name; }
+    const PointVisual& getVisual() const { return visual; }
+    sf::Color getColor() const { return visual.color; }
+    sf::Color getOutlineColor() const { return visual.outlineColor; }
+    double getSize() const { return visual.size; }
+    double getOutlineSize() const { return visual.outlineSize; }
+    bool getIsStartPoint() const { return visual.isStartPoint; }
+    bool getIsEndPoint() const { return visual.isEndPoint; }
 
     // Setters
     void setX(double newX) { x = newX; }
@@ -59,22 +90,22 @@ public:
     void setName(const string& newName) { name = newName; }
 
     // Updates the fill color; resets to base color if change=false
-    void setColor(const sf::Color& newColor = BASE_COLOR_POINT, bool change = false);
+    void setColor(const sf::Color& newColor = BASE_COLOR_POINT, bool change = false) { visual.setColor(newColor, change); }
 
     // Sets the outline color
-    void setOutlineColor(const sf::Color& newOutlineColor) { outlineColor = newOutlineColor; }
+    void setOutlineColor(const sf::Color& newOutlineColor) { visual.outlineColor = newOutlineColor; }
 
     // Sets diameter
-    void setSize(double newSize) { size = newSize; }
+    void setSize(double newSize) { visual.size = newSize; }
 
     // Sets outline thickness
-    void setOutlineSize(double newOutlineSize) { outlineSize = newOutlineSize; }
+    void setOutlineSize(double newOutlineSize) { visual.outlineSize = newOutlineSize; }
 
     // Marks the point as the algorithm's start node
-    void setIsStartPoint(bool isStart);
+    void setIsStartPoint(bool isStart) { visual.setIsStartPoint(isStart); }
 
     // Marks the point as the algorithm's end node
-    void setIsEndPoint(bool isEnd);
+    void setIsEndPoint(bool isEnd) { visual.setIsEndPoint(isEnd); }
 
     // Overloaded operators:
     // Prints the point to an output stream
@@ -0,0 +1,105 @@
+#include "PointStore.h"
+#include <utility>
+
+// Expected name length used to pre-size the pool
+#define AVERAGE_NAME_LENGTH 16
+// Pool compaction is skipped below this many dead bytes
+#define NAME_POOL_MIN_DEAD 4096
+// Characters per pool page (longer names get a page of their own)
+#define NAME_PAGE_BYTES 4096
+
+void PointStore::storeName(string_view name, uint32_t& page, uint32_t& start)
+{
+    if (namePool.empty() || namePool.back()->size() + name.size() > namePool.back()->capacity()) {
+        namePool.push_back(make_shared<vector<char>>());
+        namePool.back()->reserve(name.size() > NAME_PAGE_BYTES ? name.size() : NAME_PAGE_BYTES);
+    }
+    else {
+        // Published versions may read the page: append to a private copy
+        unshareChunk(namePool.back());
+    }
+
+    vector<char>& chars = *namePool.back();
+    page = static_cast<uint32_t>(namePool.size() - 1);
+    start = static_cast<uint32_t>(chars.size());
+    chars.insert(chars.end(), name.begin(), name.end());
+    nameBytes += name.size();
+}
+
+PointHandle PointStore::insert(const Point& p)
+{
+    uint32_t id = slots.allocate();
+    uint32_t page, start;
+    uint32_t length = static_cast<uint32_t>(p.getName().size());
+    storeName(p.getName(), page, start);
+
+    if (id == xs.size()) {
+        xs.push_back(p.getX());
+        ys.push_back(p.getY());
+        namePages.push_back(page);
+        nameStarts.push_back(start);
+        nameLengths.push_back(length);
+        visuals.push_back(p.getVisual());
+    }
+    else {
+        xs[id] = p.getX();
+        ys[id] = p.getY();
+        namePages[id] = page;
+        nameStarts[id] = start;
+        nameLengths[id] = length;
+        visuals[id] = p.getVisual();
+    }
+    return slots.handleAt(id);
+}
+
+bool PointStore::erase(PointHandle h)
+{
+    if (!slots.release(h)) return false;
+
+    // The name leaves a hole in the pool; the other columns are plain values
+    deadNameBytes += nameLengths[h.index];
+    nameLengths[h.index] = 0;
+    if (deadNameBytes > NAME_POOL_MIN_DEAD && deadNameBytes * 2 > nameBytes) compactNames();
+    return true;
+}
+
+void PointStore::compactNames()
+{
+    // New pages, so versions sharing the old ones keep their names
+    vector<shared_ptr<vector<char>>> oldPool;
+    oldPool.swap(namePool);
+    nameBytes = 0;
+    deadNameBytes = 0;
+
+    for (uint32_t id = 0; id < nameStarts.size(); id++) {
+        if (!slots.isOccupied(id)) continue;
+        string_view name(oldPool[namePages[id]]->data() + nameStarts[id], as_const(nameLengths)[id]);
+        storeName(name, namePages[id], nameStarts[id]);
+    }
+}
+
+void PointStore::clear()
+{
+    slots.clear();
+    xs.clear();
+    ys.clear();
+    namePages.clear();
+    nameStarts.clear();
+    nameLengths.clear();
+    visuals.clear();
+    namePool.clear();
+    nameBytes = 0;
+    deadNameBytes = 0;
+}
+
+void PointStore::reserve(size_t n)
+{
+    slots.reserve(n);
+    xs.reserve(n);
+    ys.reserve(n);
+    namePages.reserve(n);
+    nameStarts.reserve(n);
+    nameLengths.reserve(n);
+    visuals.reserve(n);
+    namePool.reserve(namePool.size() + n * AVERAGE_NAME_LENGTH / NAME_PAGE_BYTES + 1);
+}
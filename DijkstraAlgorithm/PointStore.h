@@ -0,0 +1,149 @@
+#pragma once
+
+#ifndef POINTSTORE_H
+#define POINTSTORE_H
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <memory>
+#include <cstdint>
+#include "Point.h"
+#include "SlotMap.h"
+#include "ChunkedColumn.h"
+
+using namespace std;
+
+class PointStore;
+
+// ------------------------------------------------------------
+// Lightweight view of a point stored in a PointStore.
+// Mirrors the Point API but reads/writes the store's columns.
+// PointRef (mutable store) can change visual state,
+// PointView (const store) is read-only.
+// ------------------------------------------------------------
+template <typename Store>
+class PointRefT
+{
+private:
+    Store* store;
+    uint32_t id;
+
+public:
+    PointRefT(Store* store, uint32_t id) : store(store), id(id) {}
+
+    // A mutable reference can always be viewed read-only
+    operator PointRefT<const PointStore>() const { return { store, id }; }
+
+    // Getters
+    double getX() const { return store->getX(id); }
+    double getY() const { return store->getY(id); }
+    string_view getName() const { return store->getName(id); }
+    uint32_t getId() const { return id; }
+    const PointVisual& getVisual() const { return static_cast<const Store*>(store)->getVisual(id); }
+    sf::Color getColor() const { return getVisual().color; }
+    sf::Color getOutlineColor() const { return getVisual().outlineColor; }
+    double getSize() const { return getVisual().size; }
+    double getOutlineSize() const { return getVisual().outlineSize; }
+    bool getIsStartPoint() const { return getVisual().isStartPoint; }
+    bool getIsEndPoint() const { return getVisual().isEndPoint; }
+
+    // Setters (only usable through a mutable store)
+    void setColor(const sf::Color& newColor = BASE_COLOR_POINT, bool change = false) const { store->getVisual(id).setColor(newColor, change); }
+    void setOutlineColor(const sf::Color& newOutlineColor) const { store->getVisual(id).outlineColor = newOutlineColor; }
+    void setSize(double newSize) const { store->getVisual(id).size = newSize; }
+    void setOutlineSize(double newOutlineSize) const { store->getVisual(id).outlineSize = newOutlineSize; }
+    void setIsStartPoint(bool isStart) const { store->getVisual(id).setIsStartPoint(isStart); }
+    void setIsEndPoint(bool isEnd) const { store->getVisual(id).setIsEndPoint(isEnd); }
+};
+
+typedef PointRefT<PointStore> PointRef;
+typedef PointRefT<const PointStore> PointView;
+
+// Handle of a stored point; Lines refer to points by handle
+typedef SlotHandle PointHandle;
+
+// ------------------------------------------------------------
+// Structure-of-arrays storage for points with slot-map semantics.
+// Coordinates live in two contiguous arrays so code that only needs
+// geometry (bounds, transforms, lengths, heuristics) streams through
+// x[] and y[] without touching names or visual attributes, which are
+// kept in their own columns. All columns are indexed by point id
+// (slot index); free slots keep stale values and are skipped.
+// Names are packed into a pool of character pages and handed out as
+// string_views; erased names leave holes that are squeezed out once
+// they make up half of the pool. A view stays valid until the next
+// insert or erase.
+// Columns and pages are shared between copies (graph versions): an
+// edit copies only the column chunks it writes and, when it adds a
+// name, the last page.
+// ------------------------------------------------------------
+class PointStore
+{
+private:
+    SlotAllocator slots;
+
+    ChunkedColumn<double> xs;               // Geometry column: x coordinates
+    ChunkedColumn<double> ys;               // Geometry column: y coordinates
+    ChunkedColumn<uint32_t> namePages;      // Name column: page of namePool
+    ChunkedColumn<uint32_t> nameStarts;     // Name column: offset in that page
+    ChunkedColumn<uint32_t> nameLengths;    // Name column: length in characters
+    ChunkedColumn<PointVisual> visuals;     // Visual attribute column
+
+    vector<shared_ptr<vector<char>>> namePool;  // Pages of names, back to back; a name never spans pages
+    size_t nameBytes = 0;           // Pool bytes of all names stored since the last compaction
+    size_t deadNameBytes = 0;       // Pool bytes of erased names
+
+    // Copies the characters to the end of the pool and sets their page and offset
+    void storeName(string_view name, uint32_t& page, uint32_t& start);
+
+    // Rewrites the pool with only the names of occupied slots
+    void compactNames();
+
+public:
+    using iterator = SlotIterator<PointStore>;
+    using const_iterator = SlotIterator<const PointStore>;
+
+    // Copies the point into the columns and returns its handle
+    PointHandle insert(const Point& p);
+
+    // Frees the slot of the handle; returns false for stale handles
+    bool erase(PointHandle h);
+
+    // Removes everything
+    void clear();
+
+    // Pre-allocates all columns (and an estimated name pool) for n points
+    void reserve(size_t n);
+
+    // Column access by point id
+    double getX(uint32_t id) const { return xs[id]; }
+    double getY(uint32_t id) const { return ys[id]; }
+    string_view getName(uint32_t id) const { return string_view(namePool[namePages[id]]->data() + nameStarts[id], nameLengths[id]); }
+    const PointVisual& getVisual(uint32_t id) const { return visuals[id]; }
+    PointVisual& getVisual(uint32_t id) { return visuals[id]; }
+
+    // Point API views
+    PointRef operator[](uint32_t id) { return PointRef(this, id); }
+    PointView operator[](uint32_t id) const { return PointView(this, id); }
+    PointRef get(PointHandle h) { return (*this)[h.index]; }
+    PointView get(PointHandle h) const { return (*this)[h.index]; }
+
+    // Slot bookkeeping
+    bool contains(PointHandle h) const { return slots.contains(h); }
+    bool isOccupied(uint32_t id) const { return slots.isOccupied(id); }
+    PointHandle handleAt(uint32_t id) const { return slots.handleAt(id); }
+    size_t size() const { return slots.size(); }
+    bool empty() const { return slots.empty(); }
+    size_t capacity() const { return slots.capacity(); }
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, static_cast<uint32_t>(capacity())); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, static_cast<uint32_t>(capacity())); }
+};
+
+// Prints a stored point the same way as a standalone Point
+ostream& operator<<(ostream& os, PointView point);
+
+#endif
@@ -0,0 +1,118 @@
+#include "Reordering.h"
+#include <algorithm>
+#include <numeric>
+#include <queue>
+
+// Resolution of the Hilbert grid per axis (2^16 cells)
+#define HILBERT_ORDER 16
+
+// -----------------------------------------------------------
+// Position of cell (x, y) along the Hilbert curve of a
+// 2^HILBERT_ORDER x 2^HILBERT_ORDER grid
+// -----------------------------------------------------------
+static uint64_t hilbertIndex(uint32_t x, uint32_t y)
+{
+    uint64_t d = 0;
+    for (uint32_t s = 1u << (HILBERT_ORDER - 1); s > 0; s >>= 1) {
+        uint32_t rx = (x & s) > 0;
+        uint32_t ry = (y & s) > 0;
+        d += static_cast<uint64_t>(s) * s * ((3 * rx) ^ ry);
+
+        // Rotate the quadrant so the curve stays continuous
+        if (ry == 0) {
+            if (rx == 1) {
+                x = s - 1 - x;
+                y = s - 1 - y;
+            }
+            swap(x, y);
+        }
+    }
+    return d;
+}
+
+// Fills both directions of an order from the list of original ids in new order
+static NodeOrder makeOrder(const vector<uint32_t>& toOld)
+{
+    NodeOrder order;
+    order.toOld = toOld;
+    order.toNew.resize(toOld.size());
+    for (size_t i = 0; i < toOld.size(); i++) order.toNew[toOld[i]] = static_cast<uint32_t>(i);
+    return order;
+}
+
+NodeOrder hilbertOrder(const PointStore& points)
+{
+    size_t n = points.capacity();
+    vector<uint32_t> ids(n);
+    iota(ids.begin(), ids.end(), 0);
+    if (points.empty()) return makeOrder(ids);
+
+    // Bounding box of the stored points
+    double minX = points.begin()->getX(), maxX = minX;
+    double minY = points.begin()->getY(), maxY = minY;
+    for (const auto& p : points) {
+        minX = min(minX, p.getX()); maxX = max(maxX, p.getX());
+        minY = min(minY, p.getY()); maxY = max(maxY, p.getY());
+    }
+    double cells = static_cast<double>((1u << HILBERT_ORDER) - 1);
+    double scaleX = maxX > minX ? cells / (maxX - minX) : 0.0;
+    double scaleY = maxY > minY ? cells / (maxY - minY) : 0.0;
+
+    // Curve position per node; free slots go to the end
+    vector<uint64_t> key(n, UINT64_MAX);
+    for (uint32_t i = 0; i < n; i++) {
+        if (!points.isOccupied(i)) continue;
+        uint32_t cx = static_cast<uint32_t>((points.getX(i) - minX) * scaleX);
+        uint32_t cy = static_cast<uint32_t>((points.getY(i) - minY) * scaleY);
+        key[i] = hilbertIndex(cx, cy);
+    }
+
+    stable_sort(ids.begin(), ids.end(), [&key](uint32_t a, uint32_t b) { return key[a] < key[b]; });
+    return makeOrder(ids);
+}
+
+template <typename NodeId, typename Weight>
+NodeOrder reverseCuthillMcKeeOrder(const Graph<NodeId, Weight>& graph)
+{
+    size_t n = graph.nodeCount();
+    auto degree = [&graph](size_t u) { return graph.end(static_cast<NodeId>(u)) - graph.begin(static_cast<NodeId>(u)); };
+
+    // Start every component from its lowest-degree node
+    vector<uint32_t> byDegree(n);
+    iota(byDegree.begin(), byDegree.end(), 0);
+    stable_sort(byDegree.begin(), byDegree.end(), [&degree](uint32_t a, uint32_t b) { return degree(a) < degree(b); });
+
+    vector<uint32_t> order;
+    order.reserve(n);
+    vector<uint8_t> visited(n, 0);
+    vector<uint32_t> neighbours;
+
+    for (uint32_t root : byDegree) {
+        if (visited[root]) continue;
+
+        // Breadth-first search, visiting neighbours by increasing degree
+        size_t head = order.size();
+        order.push_back(root);
+        visited[root] = 1;
+        while (head < order.size()) {
+            uint32_t u = order[head++];
+            neighbours.clear();
+            for (NodeId arc = graph.begin(u); arc < graph.end(u); arc++) {
+                uint32_t v = static_cast<uint32_t>(graph.target(arc));
+                if (!visited[v]) {
+                    visited[v] = 1;
+                    neighbours.push_back(v);
+                }
+            }
+            sort(neighbours.begin(), neighbours.end(), [&degree](uint32_t a, uint32_t b) { return degree(a) < degree(b); });
+            order.insert(order.end(), neighbours.begin(), neighbours.end());
+        }
+    }
+
+    reverse(order.begin(), order.end());
+    return makeOrder(order);
+}
+
+template NodeOrder reverseCuthillMcKeeOrder(const Graph<size_t, double>&);
+template NodeOrder reverseCuthillMcKeeOrder(const Graph<uint32_t, float>&);
+template NodeOrder reverseCuthillMcKeeOrder(const Graph<uint32_t, uint32_t>&);
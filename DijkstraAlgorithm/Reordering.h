@@ -0,0 +1,36 @@
+#pragma once
+
+#ifndef REORDERING_H
+#define REORDERING_H
+
+#include <vector>
+#include <cstdint>
+#include "PointStore.h"
+#include "Graph.h"
+
+using namespace std;
+
+// ------------------------------------------------------------
+// Node renumbering for memory locality.
+// Node order otherwise follows points.txt, so neighbour accesses
+// into dist[]/prev[] are scattered. A locality-preserving order
+// keeps neighbours close in memory; Graph::permuted applies it.
+// Only the benchmark runs on reordered graphs: it maps its query
+// endpoints with toNew and compares distances, so no result ids
+// need mapping back. The menu and the index builders keep the
+// point ids.
+// ------------------------------------------------------------
+struct NodeOrder
+{
+    vector<uint32_t> toNew; // Original id -> reordered id
+    vector<uint32_t> toOld; // Reordered id -> original id
+};
+
+// Order along a Hilbert space-filling curve over the point coordinates
+NodeOrder hilbertOrder(const PointStore& points);
+
+// Reverse Cuthill-McKee order (bandwidth reduction) for graphs without meaningful coordinates
+template <typename NodeId, typename Weight>
+NodeOrder reverseCuthillMcKeeOrder(const Graph<NodeId, Weight>& graph);
+
+#endif
@@ -0,0 +1,293 @@
+#include "ShortestPathQuery.h"
+#include <queue>
+#include <limits>
+#include <algorithm>
+#include <cmath>
+
+double euclideanPotentialScale(const PointStore& points, const LineStore& lines,
+    const WeightProfiles& profiles, size_t profile)
+{
+    double scale = numeric_limits<double>::infinity();
+    for (auto it = lines.begin(); it != lines.end(); ++it) {
+        double length = it->calculateLength(points);
+        if (length == 0) continue;
+
+        double weight = profiles.get(lines, profile, it.slot());
+        if (!(weight > 0)) return 0;  // Zero (or invalid) weight over a distance
+        scale = min(scale, weight / length);
+    }
+    return isfinite(scale) ? scale * POTENTIAL_SCALE_SLACK : 0;
+}
+
+template <typename GraphType>
+DijkstraQuery<GraphType>::DijkstraQuery(const GraphType& graph)
+    : graph(graph),
+      dist(graph.nodeCount(), numeric_limits<Weight>::max()),
+      prev(graph.nodeCount(), numeric_limits<NodeId>::max()),
+      prevLine(graph.nodeCount(), numeric_limits<NodeId>::max())
+{
+}
+
+template <typename GraphType>
+PathResult<typename DijkstraQuery<GraphType>::NodeId, typename DijkstraQuery<GraphType>::Weight>
+DijkstraQuery<GraphType>::run(NodeId source, NodeId target)
+{
+    const NodeId none = numeric_limits<NodeId>::max();
+    const Weight unreached = numeric_limits<Weight>::max();
+
+    // Reset only what the previous run touched
+    for (NodeId v : touched) {
+        dist[v] = unreached;
+        prev[v] = none;
+        prevLine[v] = none;
+    }
+    touched.clear();
+    settled = 0;
+
+    // Min-heap on distance
+    typedef pair<Weight, NodeId> Entry;
+    priority_queue<Entry, vector<Entry>, greater<Entry>> pq;
+
+    dist[source] = Weight();
+    touched.push_back(source);
+    pq.push({ Weight(), source });
+
+    while (!pq.empty()) {
+        auto [d, u] = pq.top();
+        pq.pop();
+
+        if (d > dist[u]) continue;  // Skip outdated values
+        settled++;
+        if (u == target) break;
+        if (observer) observer->onSettle(u, 0);
+
+        graph.forEachArc(u, [&](NodeId v, Weight weight, NodeId lineId) {
+            Weight alt = d + weight;
+            bool improved = alt < dist[v];
+
+            if (improved) {
+                if (dist[v] == unreached) touched.push_back(v);
+                dist[v] = alt;
+                prev[v] = u;
+                prevLine[v] = lineId;
+                pq.push({ alt, v });
+            }
+            if (observer) observer->onRelax(u, v, lineId, improved, 0);
+        });
+    }
+
+    PathResult<NodeId, Weight> result;
+    if (dist[target] == unreached) return result;
+
+    // Walk the predecessors back to the source
+    result.found = true;
+    result.distance = dist[target];
+    for (NodeId v = target; v != source; v = prev[v]) {
+        result.nodes.push_back(v);
+        result.lines.push_back(prevLine[v]);
+    }
+    result.nodes.push_back(source);
+    reverse(result.nodes.begin(), result.nodes.end());
+    reverse(result.lines.begin(), result.lines.end());
+    return result;
+}
+
+template <typename GraphType>
+BidirectionalDijkstraQuery<GraphType>::BidirectionalDijkstraQuery(const GraphType& graph)
+    : graph(graph)
+{
+    for (int side = 0; side < 2; side++) {
+        dist[side].assign(graph.nodeCount(), numeric_limits<Weight>::max());
+        prev[side].assign(graph.nodeCount(), numeric_limits<NodeId>::max());
+        prevLine[side].assign(graph.nodeCount(), numeric_limits<NodeId>::max());
+    }
+}
+
+template <typename GraphType>
+PathResult<typename BidirectionalDijkstraQuery<GraphType>::NodeId, typename BidirectionalDijkstraQuery<GraphType>::Weight>
+BidirectionalDijkstraQuery<GraphType>::run(NodeId source, NodeId target)
+{
+    const NodeId none = numeric_limits<NodeId>::max();
+    const Weight unreached = numeric_limits<Weight>::max();
+
+    // Reset only what the previous run touched
+    for (int side = 0; side < 2; side++) {
+        for (NodeId v : touched[side]) {
+            dist[side][v] = unreached;
+            prev[side][v] = none;
+            prevLine[side][v] = none;
+        }
+        touched[side].clear();
+    }
+    settled = 0;
+
+    typedef pair<Weight, NodeId> Entry;
+    priority_queue<Entry, vector<Entry>, greater<Entry>> pq[2];
+
+    dist[0][source] = Weight();
+    dist[1][target] = Weight();
+    touched[0].push_back(source);
+    touched[1].push_back(target);
+    pq[0].push({ Weight(), source });
+    pq[1].push({ Weight(), target });
+
+    Weight best = source == target ? Weight() : unreached;
+    NodeId meeting = source == target ? source : none;
+
+    while (!pq[0].empty() && !pq[1].empty()) {
+        // Meeting-point criterion (the sum cannot overflow: both heads are below 'best')
+        Weight head0 = pq[0].top().first, head1 = pq[1].top().first;
+        if (head0 >= best || head1 >= best || head0 + head1 >= best) break;
+
+        int side = head0 <= head1 ? 0 : 1;
+        auto [d, u] = pq[side].top();
+        pq[side].pop();
+
+        if (d > dist[side][u]) continue;  // Skip outdated values
+        settled++;
+        if (observer) observer->onSettle(u, side);
+
+        auto relax = [&](NodeId v, Weight weight, NodeId lineId) {
+            Weight alt = d + weight;
+            bool improved = alt < dist[side][v];
+
+            if (improved) {
+                if (dist[side][v] == unreached) touched[side].push_back(v);
+                dist[side][v] = alt;
+                prev[side][v] = u;
+                prevLine[side][v] = lineId;
+                pq[side].push({ alt, v });
+            }
+            if (observer) observer->onRelax(u, v, lineId, improved, side);
+
+            // Path through v joining both searches
+            if (dist[1 - side][v] != unreached && dist[side][v] + dist[1 - side][v] < best) {
+                best = dist[side][v] + dist[1 - side][v];
+                meeting = v;
+            }
+        };
+
+        if (side == 0) graph.forEachArc(u, relax);
+        else graph.forEachReverseArc(u, relax);
+    }
+
+    PathResult<NodeId, Weight> result;
+    if (meeting == none) return result;
+
+    // Forward half back to the source, then the backward half on to the target
+    result.found = true;
+    result.distance = best;
+    for (NodeId v = meeting; v != source; v = prev[0][v]) {
+        result.nodes.push_back(v);
+        result.lines.push_back(prevLine[0][v]);
+    }
+    result.nodes.push_back(source);
+    reverse(result.nodes.begin(), result.nodes.end());
+    reverse(result.lines.begin(), result.lines.end());
+    for (NodeId v = meeting; v != target; v = prev[1][v]) {
+        result.nodes.push_back(prev[1][v]);
+        result.lines.push_back(prevLine[1][v]);
+    }
+    return result;
+}
+
+double EuclideanPotential::operator()(uint32_t v) const
+{
+    return scale * hypot(x[v] - targetX, y[v] - targetY);
+}
+
+template <typename GraphType, typename PotentialType>
+AStarQuery<GraphType, PotentialType>::AStarQuery(const GraphType& graph, const PotentialType& potential)
+    : graph(graph), potential(potential),
+      dist(graph.nodeCount(), numeric_limits<Weight>::max()),
+      prev(graph.nodeCount(), numeric_limits<NodeId>::max()),
+      prevLine(graph.nodeCount(), numeric_limits<NodeId>::max())
+{
+}
+
+template <typename GraphType, typename PotentialType>
+PathResult<typename AStarQuery<GraphType, PotentialType>::NodeId, typename AStarQuery<GraphType, PotentialType>::Weight>
+AStarQuery<GraphType, PotentialType>::run(NodeId source, NodeId target)
+{
+    const NodeId none = numeric_limits<NodeId>::max();
+    const Weight unreached = numeric_limits<Weight>::max();
+
+    // Reset only what the previous run touched
+    for (NodeId v : touched) {
+        dist[v] = unreached;
+        prev[v] = none;
+        prevLine[v] = none;
+    }
+    touched.clear();
+    settled = 0;
+
+    // Potential: lower bound of the remaining distance to the target
+    potential.setTarget(static_cast<uint32_t>(target));
+
+    // Min-heap on distance + potential
+    typedef pair<double, NodeId> Entry;
+    priority_queue<Entry, vector<Entry>, greater<Entry>> pq;
+
+    dist[source] = Weight();
+    touched.push_back(source);
+    pq.push({ potential(source), source });
+
+    while (!pq.empty()) {
+        auto [key, u] = pq.top();
+        pq.pop();
+
+        if (key > dist[u] + potential(u)) continue;  // Skip outdated values
+        settled++;
+        if (u == target) break;
+        if (observer) observer->onSettle(u, 0);
+
+        graph.forEachArc(u, [&](NodeId v, Weight weight, NodeId lineId) {
+            Weight alt = dist[u] + weight;
+            bool improved = alt < dist[v];
+
+            if (improved) {
+                if (dist[v] == unreached) touched.push_back(v);
+                dist[v] = alt;
+                prev[v] = u;
+                prevLine[v] = lineId;
+                pq.push({ alt + potential(v), v });
+            }
+            if (observer) observer->onRelax(u, v, lineId, improved, 0);
+        });
+    }
+
+    PathResult<NodeId, Weight> result;
+    if (dist[target] == unreached) return result;
+
+    // Walk the predecessors back to the source
+    result.found = true;
+    result.distance = dist[target];
+    for (NodeId v = target; v != source; v = prev[v]) {
+        result.nodes.push_back(v);
+        result.lines.push_back(prevLine[v]);
+    }
+    result.nodes.push_back(source);
+    reverse(result.nodes.begin(), result.nodes.end());
+    reverse(result.lines.begin(), result.lines.end());
+    return result;
+}
+
+template class DijkstraQuery<Graph<size_t, double>>;
+template class DijkstraQuery<Graph<uint32_t, float>>;
+template class DijkstraQuery<Graph<uint32_t, uint32_t>>;
+template class DijkstraQuery<ReverseGraph<Graph<size_t, double>>>;
+template class DijkstraQuery<ReverseGraph<Graph<uint32_t, uint32_t>>>;
+template class DijkstraQuery<ProfileGraph<Graph<size_t, double>>>;
+template class DijkstraQuery<CompressedGraph>;
+template class DijkstraQuery<GraphSnapshot>;
+template class DijkstraQuery<VersionGraph>;
+template class BidirectionalDijkstraQuery<Graph<size_t, double>>;
+template class BidirectionalDijkstraQuery<Graph<uint32_t, uint32_t>>;
+template class BidirectionalDijkstraQuery<ProfileGraph<Graph<size_t, double>>>;
+template class BidirectionalDijkstraQuery<VersionGraph>;
+template class AStarQuery<Graph<size_t, double>>;
+template class AStarQuery<ProfileGraph<Graph<size_t, double>>>;
+template class AStarQuery<Graph<size_t, double>, LandmarkPotential>;
+template class AStarQuery<ProfileGraph<Graph<size_t, double>>, LandmarkPotential>;
+template class AStarQuery<VersionGraph>;
+template class AStarQuery<VersionGraph, LandmarkPotential>;
@@ -0,0 +1,222 @@
+#pragma once
+
+#ifndef SHORTESTPATHQUERY_H
+#define SHORTESTPATHQUERY_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "Graph.h"
+#include "CompressedGraph.h"
+#include "GraphSnapshot.h"
+#include "GraphVersion.h"
+#include "WeightProfiles.h"
+#include "Landmarks.h"
+
+using namespace std;
+
+// Factor applied to the A* potential scale so rounding in the
+// distance computation cannot make the potential inconsistent
+#define POTENTIAL_SCALE_SLACK (1.0 - 1e-9)
+
+// ------------------------------------------------------------
+// Scale of the Euclidean A* potential for one weight profile:
+// the minimum weight / length ratio over all lines, so that
+// scale * straight-line distance never exceeds the path weight
+// and, per line, |h(u) - h(v)| <= scale * length <= weight
+// (admissible and consistent). Zero-length lines do not limit it.
+// Returns 0 when no such potential exists (no lines, or a line
+// of zero weight but positive length): searches then fall back
+// to plain Dijkstra.
+// ------------------------------------------------------------
+double euclideanPotentialScale(const PointStore& points, const LineStore& lines,
+    const WeightProfiles& profiles, size_t profile);
+
+// ------------------------------------------------------------
+// Result of a point-to-point query: total distance plus the node
+// and line ids along the path (source first). 'found' is false
+// when the target is unreachable.
+// ------------------------------------------------------------
+template <typename NodeId, typename Weight>
+struct PathResult
+{
+    bool found = false;
+    Weight distance = Weight();
+    vector<NodeId> nodes;
+    vector<NodeId> lines;
+};
+
+// ------------------------------------------------------------
+// Optional hook into a running query (e.g. the menu's animation):
+// onSettle for every settled node, onRelax for every arc relaxed
+// from it ('improved' if it lowered the head's distance). Side 0 is
+// the forward search, 1 the backward one. Queries without an
+// observer pay one null check per arc.
+// ------------------------------------------------------------
+class SearchObserver
+{
+public:
+    virtual ~SearchObserver() {}
+    virtual void onSettle(size_t, int) {}
+    virtual void onRelax(size_t, size_t, size_t, bool, int) {}
+};
+
+// ------------------------------------------------------------
+// Point-to-point Dijkstra on any CSR-like graph type (Graph<NodeId,
+// Weight>, ReverseGraph, CompressedGraph, GraphSnapshot) exposing NodeType, WeightType,
+// nodeCount() and forEachArc(u, f), without visualization.
+// Heap entries are (Weight, NodeId) pairs, so the 32-bit graphs
+// also halve the queue's memory traffic.
+// The distance arrays are kept between runs and only the touched
+// entries are reset, so repeated queries cost O(settled) each.
+// ------------------------------------------------------------
+template <typename GraphType>
+class DijkstraQuery
+{
+public:
+    typedef typename GraphType::NodeType NodeId;
+    typedef typename GraphType::WeightType Weight;
+
+private:
+    const GraphType& graph;
+
+    vector<Weight> dist;    // Tentative distance per node
+    vector<NodeId> prev;    // Predecessor of each node
+    vector<NodeId> prevLine; // Line used to reach each node
+    vector<NodeId> touched; // Nodes whose entries must be reset before the next run
+    size_t settled = 0;     // Nodes settled by the last run
+    SearchObserver* observer = nullptr;
+
+public:
+    explicit DijkstraQuery(const GraphType& graph);
+
+    // Reports the settled nodes and relaxed arcs of the following runs (null = none)
+    void setObserver(SearchObserver* searchObserver) { observer = searchObserver; }
+
+    // Shortest path from source to target
+    PathResult<NodeId, Weight> run(NodeId source, NodeId target);
+
+    // Number of nodes settled by the last run (search space size)
+    size_t settledCount() const { return settled; }
+};
+
+// ------------------------------------------------------------
+// Bidirectional Dijkstra: a forward search from the source and a
+// backward search over the reverse arcs from the target, always
+// advancing the side with the smaller queue head. Stops when the
+// two heads together reach the best meeting distance, which then
+// is optimal. Settles roughly two half-radius discs instead of one
+// full disc. Needs forEachReverseArc (Graph, ProfileGraph).
+// ------------------------------------------------------------
+template <typename GraphType>
+class BidirectionalDijkstraQuery
+{
+public:
+    typedef typename GraphType::NodeType NodeId;
+    typedef typename GraphType::WeightType Weight;
+
+private:
+    const GraphType& graph;
+
+    // Index 0 = forward search, 1 = backward search (prev = next node towards the target)
+    vector<Weight> dist[2];
+    vector<NodeId> prev[2];
+    vector<NodeId> prevLine[2];
+    vector<NodeId> touched[2];
+    size_t settled = 0;
+    SearchObserver* observer = nullptr;
+
+public:
+    explicit BidirectionalDijkstraQuery(const GraphType& graph);
+
+    // Reports the settled nodes and relaxed arcs of the following runs (null = none)
+    void setObserver(SearchObserver* searchObserver) { observer = searchObserver; }
+
+    // Shortest path from source to target
+    PathResult<NodeId, Weight> run(NodeId source, NodeId target);
+
+    // Number of nodes settled by both searches of the last run
+    size_t settledCount() const { return settled; }
+};
+
+// ------------------------------------------------------------
+// A* potential: scale * Euclidean distance to the target.
+// x/y hold the coordinates of every node id of the graph (in its
+// numbering); scale 0 turns A* into plain Dijkstra.
+// ------------------------------------------------------------
+class EuclideanPotential
+{
+private:
+    const vector<double>& x;
+    const vector<double>& y;
+    double scale;
+    double targetX = 0, targetY = 0;
+
+public:
+    EuclideanPotential(const vector<double>& x, const vector<double>& y, double scale) : x(x), y(y), scale(scale) {}
+
+    void setTarget(uint32_t target) { targetX = x[target]; targetY = y[target]; }
+    double operator()(uint32_t v) const;
+};
+
+// ------------------------------------------------------------
+// A* search: Dijkstra ordered by distance + a lower bound of the
+// remaining distance (the potential), so the search grows towards
+// the target instead of as a disc around the source.
+// PotentialType provides setTarget(t) and operator()(v); with a
+// consistent potential (EuclideanPotential scaled by
+// euclideanPotentialScale, LandmarkPotential) the result equals
+// Dijkstra's.
+// ------------------------------------------------------------
+template <typename GraphType, typename PotentialType = EuclideanPotential>
+class AStarQuery
+{
+public:
+    typedef typename GraphType::NodeType NodeId;
+    typedef typename GraphType::WeightType Weight;
+
+private:
+    const GraphType& graph;
+    PotentialType potential;
+
+    vector<Weight> dist;
+    vector<NodeId> prev;
+    vector<NodeId> prevLine;
+    vector<NodeId> touched;
+    size_t settled = 0;
+    SearchObserver* observer = nullptr;
+
+public:
+    AStarQuery(const GraphType& graph, const PotentialType& potential);
+
+    // Reports the settled nodes and relaxed arcs of the following runs (null = none)
+    void setObserver(SearchObserver* searchObserver) { observer = searchObserver; }
+
+    // Shortest path from source to target
+    PathResult<NodeId, Weight> run(NodeId source, NodeId target);
+
+    // Number of nodes settled by the last run (search space size)
+    size_t settledCount() const { return settled; }
+};
+
+extern template class DijkstraQuery<Graph<size_t, double>>;
+extern template class DijkstraQuery<Graph<uint32_t, float>>;
+extern template class DijkstraQuery<Graph<uint32_t, uint32_t>>;
+extern template class DijkstraQuery<ReverseGraph<Graph<size_t, double>>>;
+extern template class DijkstraQuery<ReverseGraph<Graph<uint32_t, uint32_t>>>;
+extern template class DijkstraQuery<ProfileGraph<Graph<size_t, double>>>;
+extern template class DijkstraQuery<CompressedGraph>;
+extern template class DijkstraQuery<GraphSnapshot>;
+extern template class DijkstraQuery<VersionGraph>;
+extern template class BidirectionalDijkstraQuery<Graph<size_t, double>>;
+extern template class BidirectionalDijkstraQuery<Graph<uint32_t, uint32_t>>;
+extern template class BidirectionalDijkstraQuery<ProfileGraph<Graph<size_t, double>>>;
+extern template class BidirectionalDijkstraQuery<VersionGraph>;
+extern template class AStarQuery<Graph<size_t, double>>;
+extern template class AStarQuery<ProfileGraph<Graph<size_t, double>>>;
+extern template class AStarQuery<Graph<size_t, double>, LandmarkPotential>;
+extern template class AStarQuery<ProfileGraph<Graph<size_t, double>>, LandmarkPotential>;
+extern template class AStarQuery<VersionGraph>;
+extern template class AStarQuery<VersionGraph, LandmarkPotential>;
+
+#endif
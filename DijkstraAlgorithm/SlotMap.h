@@ -0,0 +1,220 @@
+#pragma once
+
+#ifndef SLOTMAP_H
+#define SLOTMAP_H
+
+#include <vector>
+#include <optional>
+#include <cstdint>
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include "ChunkedColumn.h"
+
+using namespace std;
+
+// ------------------------------------------------------------
+// Stable reference to an element of a slot container.
+// 'index' is the slot (reused after deletion), 'generation' is
+// bumped every time the slot is freed, so a handle to a deleted
+// element never silently resolves to a newer one.
+// ------------------------------------------------------------
+struct SlotHandle
+{
+    uint32_t index = UINT32_MAX;
+    uint32_t generation = 0;
+
+    friend bool operator==(const SlotHandle& a, const SlotHandle& b) {
+        return a.index == b.index && a.generation == b.generation;
+    }
+    friend bool operator!=(const SlotHandle& a, const SlotHandle& b) { return !(a == b); }
+};
+
+// ------------------------------------------------------------
+// Slot bookkeeping shared by slot containers: generations, free
+// list and occupancy. Containers keep their data in columns
+// indexed by slot and grow them when allocate() opens a new slot.
+// All of it is chunked, so copies share everything but the chunks
+// an edit touches.
+// ------------------------------------------------------------
+class SlotAllocator
+{
+private:
+    ChunkedColumn<uint32_t> generations;    // Current generation of each slot
+    ChunkedColumn<uint8_t> occupied;        // 1 if the slot holds a live element
+    ChunkedColumn<uint32_t> freeSlots;      // Stack of free slot indices
+    size_t count = 0;               // Number of occupied slots
+
+public:
+    // Takes a free slot (or opens a new one at capacity()) and returns its index
+    uint32_t allocate() {
+        uint32_t index;
+        if (!freeSlots.empty()) {
+            index = freeSlots.back();
+            freeSlots.pop_back();
+        }
+        else {
+            index = static_cast<uint32_t>(generations.size());
+            generations.push_back(0);
+            occupied.push_back(0);
+        }
+        occupied[index] = 1;
+        count++;
+        return index;
+    }
+
+    // Frees the slot of the handle; returns false for stale handles
+    bool release(SlotHandle h) {
+        if (!contains(h)) return false;
+        occupied[h.index] = 0;
+        generations[h.index]++;
+        freeSlots.push_back(h.index);
+        count--;
+        return true;
+    }
+
+    // Checks whether the handle still refers to a live element
+    bool contains(SlotHandle h) const {
+        return h.index < generations.size() && generations[h.index] == h.generation && occupied[h.index];
+    }
+
+    bool isOccupied(uint32_t index) const { return index < occupied.size() && occupied[index]; }
+    SlotHandle handleAt(uint32_t index) const { return { index, generations[index] }; }
+
+    // Number of live elements
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    // Number of slots (upper bound of slot indices)
+    size_t capacity() const { return generations.size(); }
+
+    // Pre-allocates bookkeeping for n slots
+    void reserve(size_t n) {
+        generations.reserve(n);
+        occupied.reserve(n);
+    }
+
+    // Frees everything; generations restart because no handles survive
+    void clear() {
+        generations.clear();
+        occupied.clear();
+        freeSlots.clear();
+        count = 0;
+    }
+};
+
+// ------------------------------------------------------------
+// Iterates over occupied slots of a slot container.
+// The container's operator[] may return a reference or a proxy.
+// ------------------------------------------------------------
+template <typename Map>
+class SlotIterator
+{
+private:
+    Map* map;
+    uint32_t index;
+
+    void skipFree() {
+        while (index < map->capacity() && !map->isOccupied(index)) index++;
+    }
+
+public:
+    using reference = decltype(declval<Map&>()[0u]);
+    using value_type = remove_cv_t<remove_reference_t<reference>>;
+    using iterator_category = forward_iterator_tag;
+    using difference_type = ptrdiff_t;
+
+    // Lets operator-> work for proxies as well as references
+    struct pointer {
+        reference ref;
+        auto operator->() { return &ref; }
+    };
+
+    SlotIterator(Map* map, uint32_t index) : map(map), index(index) { skipFree(); }
+
+    reference operator*() const { return (*map)[index]; }
+    pointer operator->() const { return { (*map)[index] }; }
+    SlotIterator& operator++() { index++; skipFree(); return *this; }
+    SlotIterator operator++(int) { SlotIterator tmp = *this; ++(*this); return tmp; }
+    bool operator==(const SlotIterator& other) const { return index == other.index; }
+    bool operator!=(const SlotIterator& other) const { return index != other.index; }
+
+    // Slot index of the current element
+    uint32_t slot() const { return index; }
+};
+
+// ------------------------------------------------------------
+// Generational slot map of whole objects.
+// Insert and erase are O(1); freed slots are reused, so slot
+// indices stay dense enough to size per-element arrays by
+// capacity(). Elements never move between slots, so handles
+// (and slot indices) stay valid until the element is erased.
+// Elements are kept in a chunked column: copying the map shares
+// them, and the non-const accessors unshare the chunk they write.
+// ------------------------------------------------------------
+template <typename T>
+class SlotMap
+{
+private:
+    SlotAllocator slots;
+    ChunkedColumn<optional<T>> values; // Element of each slot (empty if free)
+
+public:
+    using iterator = SlotIterator<SlotMap>;
+    using const_iterator = SlotIterator<const SlotMap>;
+
+    // Stores a copy of the value and returns its handle
+    SlotHandle insert(const T& value) {
+        uint32_t index = slots.allocate();
+        if (index == values.size()) values.push_back(optional<T>(value));
+        else values[index].emplace(value);
+        return slots.handleAt(index);
+    }
+
+    // Frees the slot of the handle; returns false for stale handles
+    bool erase(SlotHandle h) {
+        if (!slots.release(h)) return false;
+        values[h.index].reset();
+        return true;
+    }
+
+    bool contains(SlotHandle h) const { return slots.contains(h); }
+
+    // Returns a pointer to the element or nullptr for stale handles
+    T* find(SlotHandle h) { return contains(h) ? &*values[h.index] : nullptr; }
+    const T* find(SlotHandle h) const { return contains(h) ? &*values[h.index] : nullptr; }
+
+    // Unchecked access by handle
+    T& get(SlotHandle h) { return *values[h.index]; }
+    const T& get(SlotHandle h) const { return *values[h.index]; }
+
+    // Unchecked access by slot index
+    T& operator[](uint32_t index) { return *values[index]; }
+    const T& operator[](uint32_t index) const { return *values[index]; }
+
+    // Slot bookkeeping
+    bool isOccupied(uint32_t index) const { return slots.isOccupied(index); }
+    SlotHandle handleAt(uint32_t index) const { return slots.handleAt(index); }
+    size_t size() const { return slots.size(); }
+    bool empty() const { return slots.empty(); }
+    size_t capacity() const { return slots.capacity(); }
+
+    // Pre-allocates room for n elements
+    void reserve(size_t n) {
+        slots.reserve(n);
+        values.reserve(n);
+    }
+
+    // Removes everything
+    void clear() {
+        slots.clear();
+        values.clear();
+    }
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, static_cast<uint32_t>(capacity())); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, static_cast<uint32_t>(capacity())); }
+};
+
+#endif
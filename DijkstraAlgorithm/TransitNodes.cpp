@@ -0,0 +1,356 @@
+#include "TransitNodes.h"
+#include "ParallelFor.h"
+#include <queue>
+#include <limits>
+#include <algorithm>
+#include <functional>
+#include <cmath>
+
+void TransitNodeRouting::build(const ContractionHierarchy& hierarchy, const vector<double>& x, const vector<double>& y,
+    size_t transitCount, unsigned threads)
+{
+    size_t n = hierarchy.nodeCount();
+    if (transitCount == 0) {
+        size_t budgetCount = static_cast<size_t>(sqrt(TNR_TABLE_BUDGET / static_cast<double>(sizeof(double) + sizeof(uint32_t))));
+        transitCount = min(static_cast<size_t>(TNR_TRANSIT_FACTOR * sqrt(static_cast<double>(n))), budgetCount);
+    }
+    size_t count = min(transitCount, n);
+    if (threads == 0) threads = workerCount(hierarchy.arcCount());
+
+    // The last 'count' nodes of the contraction order
+    transitOf.assign(n, UINT32_MAX);
+    transitNodes.assign(count, 0);
+    for (uint32_t v = 0; v < n; v++) {
+        uint32_t r = hierarchy.rank[v];
+        if (r < n - count) continue;
+        transitOf[v] = static_cast<uint32_t>(r - (n - count));
+        transitNodes[transitOf[v]] = v;
+    }
+    fingerprint = hierarchy.getFingerprint();
+
+    buildTable(hierarchy);
+    for (int side = 0; side < 2; side++) buildAccess(hierarchy, side, x, y, threads);
+}
+
+// -----------------------------------------------------------
+// The up-down path between two transit nodes only visits nodes
+// above the lower of them, i.e. transit nodes, so Dijkstra on the
+// hierarchy arcs among the transit nodes gives exact distances.
+// Each search also keeps the predecessor of every transit node.
+// -----------------------------------------------------------
+void TransitNodeRouting::buildTable(const ContractionHierarchy& hierarchy)
+{
+    size_t count = transitNodes.size();
+    vector<vector<pair<uint32_t, double>>> out(count);
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t u = transitNodes[i];
+        for (uint32_t arc = hierarchy.upOffsets[u]; arc < hierarchy.upOffsets[u + 1]; arc++) {
+            out[i].push_back({ transitOf[hierarchy.upArcs[arc].node], hierarchy.upArcs[arc].weight });
+        }
+        for (uint32_t arc = hierarchy.downOffsets[u]; arc < hierarchy.downOffsets[u + 1]; arc++) {
+            out[transitOf[hierarchy.downArcs[arc].node]].push_back({ i, hierarchy.downArcs[arc].weight });
+        }
+    }
+
+    table.assign(count * count, numeric_limits<double>::infinity());
+    via.assign(count * count, UINT32_MAX);
+    typedef pair<double, uint32_t> Entry;
+    parallelChunks(count, workerCount(count * count), [&](unsigned, size_t begin, size_t end) {
+        priority_queue<Entry, vector<Entry>, greater<Entry>> pq;
+        for (size_t a = begin; a < end; a++) {
+            double* dist = &table[a * count];
+            uint32_t* prev = &via[a * count];
+            dist[a] = 0.0;
+            pq.push({ 0.0, static_cast<uint32_t>(a) });
+            while (!pq.empty()) {
+                auto [d, u] = pq.top();
+                pq.pop();
+                if (d > dist[u]) continue;  // Skip outdated values
+
+                for (const auto& [v, weight] : out[u]) {
+                    if (d + weight < dist[v]) {
+                        dist[v] = d + weight;
+                        prev[v] = u;
+                        pq.push({ dist[v], v });
+                    }
+                }
+            }
+        }
+    });
+}
+
+// -----------------------------------------------------------
+// Upward search from every node (side 0 over the upward arcs,
+// side 1 over the downward arcs into it), not continued past
+// transit nodes. Access nodes are kept in order of distance,
+// skipping those another kept one reaches at no extra cost.
+// Chunks of nodes collect their entries separately; being
+// contiguous, they are concatenated in order.
+// -----------------------------------------------------------
+void TransitNodeRouting::buildAccess(const ContractionHierarchy& hierarchy, int side, const vector<double>& x,
+    const vector<double>& y, unsigned threads)
+{
+    const vector<uint32_t>& offsets = side == 0 ? hierarchy.upOffsets : hierarchy.downOffsets;
+    const vector<ContractionHierarchy::Arc>& arcs = side == 0 ? hierarchy.upArcs : hierarchy.downArcs;
+    size_t n = transitOf.size();
+    size_t count = transitNodes.size();
+
+    boxes[side].assign(n, Box());
+    accessOffsets[side].assign(n + 1, 0);
+    vector<vector<uint32_t>> chunkNodes(threads);
+    vector<vector<double>> chunkDistances(threads);
+
+    parallelChunks(n, threads, [&](unsigned chunk, size_t begin, size_t end) {
+        vector<double> dist(n, numeric_limits<double>::infinity());
+        vector<uint32_t> touched;
+        vector<pair<uint32_t, double>> reached, kept;
+
+        typedef pair<double, uint32_t> Entry;
+        priority_queue<Entry, vector<Entry>, greater<Entry>> pq;
+
+        for (size_t v = begin; v < end; v++) {
+            for (uint32_t u : touched) dist[u] = numeric_limits<double>::infinity();
+            touched.clear();
+            reached.clear();
+
+            Box box = { numeric_limits<double>::infinity(), numeric_limits<double>::infinity(),
+                -numeric_limits<double>::infinity(), -numeric_limits<double>::infinity() };
+            dist[v] = 0.0;
+            touched.push_back(static_cast<uint32_t>(v));
+            pq.push({ 0.0, static_cast<uint32_t>(v) });
+            while (!pq.empty()) {
+                auto [d, u] = pq.top();
+                pq.pop();
+                if (d > dist[u]) continue;  // Skip outdated values
+
+                if (transitOf[u] != UINT32_MAX) {
+                    reached.push_back({ transitOf[u], d });
+                    continue;
+                }
+                box.minX = min(box.minX, x[u]);
+                box.minY = min(box.minY, y[u]);
+                box.maxX = max(box.maxX, x[u]);
+                box.maxY = max(box.maxY, y[u]);
+
+                for (uint32_t arc = offsets[u]; arc < offsets[u + 1]; arc++) {
+                    uint32_t w = arcs[arc].node;
+                    double alt = d + arcs[arc].weight;
+                    if (alt < dist[w]) {
+                        if (dist[w] == numeric_limits<double>::infinity()) touched.push_back(w);
+                        dist[w] = alt;
+                        pq.push({ alt, w });
+                    }
+                }
+            }
+            boxes[side][v] = box;
+
+            // 'reached' is in order of distance
+            kept.clear();
+            for (const auto& [a, d] : reached) {
+                bool dominated = false;
+                for (const auto& [b, e] : kept) {
+                    double via = side == 0 ? table[b * count + a] : table[a * count + b];
+                    if (e + via <= d) {
+                        dominated = true;
+                        break;
+                    }
+                }
+                if (dominated) continue;
+                kept.push_back({ a, d });
+                chunkNodes[chunk].push_back(a);
+                chunkDistances[chunk].push_back(d);
+            }
+            accessOffsets[side][v + 1] = static_cast<uint32_t>(kept.size());
+        }
+    });
+
+    for (size_t v = 0; v < n; v++) accessOffsets[side][v + 1] += accessOffsets[side][v];
+    accessNodes[side].clear();
+    accessDistances[side].clear();
+    for (unsigned chunk = 0; chunk < threads; chunk++) {
+        accessNodes[side].insert(accessNodes[side].end(), chunkNodes[chunk].begin(), chunkNodes[chunk].end());
+        accessDistances[side].insert(accessDistances[side].end(), chunkDistances[chunk].begin(), chunkDistances[chunk].end());
+    }
+}
+
+double TransitNodeRouting::averageAccessCount() const
+{
+    if (transitOf.empty()) return 0;
+    return static_cast<double>(accessNodes[0].size() + accessNodes[1].size()) / (2.0 * transitOf.size());
+}
+
+bool TransitNodeRouting::isLocal(uint32_t s, uint32_t t) const
+{
+    const Box& a = boxes[0][s];
+    const Box& b = boxes[1][t];
+    return a.minX <= b.maxX && b.minX <= a.maxX && a.minY <= b.maxY && b.minY <= a.maxY;
+}
+
+double TransitNodeRouting::distance(uint32_t s, uint32_t t, size_t* lookups, uint32_t* sourceAccess, uint32_t* targetAccess) const
+{
+    size_t count = transitNodes.size();
+    double best = numeric_limits<double>::infinity();
+    uint32_t bestI = accessOffsets[0][s], bestJ = accessOffsets[1][t];
+    for (uint32_t i = accessOffsets[0][s]; i < accessOffsets[0][s + 1]; i++) {
+        const double* row = &table[accessNodes[0][i] * count];
+        double first = accessDistances[0][i];
+        for (uint32_t j = accessOffsets[1][t]; j < accessOffsets[1][t + 1]; j++) {
+            double alt = first + row[accessNodes[1][j]] + accessDistances[1][j];
+            if (alt < best) {
+                best = alt;
+                bestI = i;
+                bestJ = j;
+            }
+        }
+    }
+    if (lookups) *lookups = (accessOffsets[0][s + 1] - accessOffsets[0][s]) * (accessOffsets[1][t + 1] - accessOffsets[1][t]);
+    if (sourceAccess && best != numeric_limits<double>::infinity()) *sourceAccess = accessNodes[0][bestI];
+    if (targetAccess && best != numeric_limits<double>::infinity()) *targetAccess = accessNodes[1][bestJ];
+    return best;
+}
+
+// -----------------------------------------------------------
+// Walks the table predecessors back from b, then unpacks the
+// hierarchy arc between each two consecutive transit nodes (an
+// upward arc of the lower one or a downward arc into it)
+// -----------------------------------------------------------
+void TransitNodeRouting::appendTablePath(const ContractionHierarchy& hierarchy, uint32_t a, uint32_t b,
+    vector<uint32_t>& nodes, vector<uint32_t>& lines) const
+{
+    size_t count = transitNodes.size();
+    vector<uint32_t> chain;
+    for (uint32_t v = b; v != a; v = via[a * count + v]) chain.push_back(v);
+    chain.push_back(a);
+
+    for (size_t i = chain.size() - 1; i > 0; i--) {
+        uint32_t from = transitNodes[chain[i]];
+        uint32_t to = transitNodes[chain[i - 1]];
+        if (hierarchy.rank[from] < hierarchy.rank[to]) {
+            for (uint32_t arc = hierarchy.upOffsets[from]; arc < hierarchy.upOffsets[from + 1]; arc++) {
+                const ContractionHierarchy::Arc& up = hierarchy.upArcs[arc];
+                if (up.node != to) continue;
+                hierarchy.unpack(from, to, up.middle, up.lineId, nodes, lines);
+                break;
+            }
+        } else {
+            for (uint32_t arc = hierarchy.downOffsets[to]; arc < hierarchy.downOffsets[to + 1]; arc++) {
+                const ContractionHierarchy::Arc& down = hierarchy.downArcs[arc];
+                if (down.node != from) continue;
+                hierarchy.unpack(from, to, down.middle, down.lineId, nodes, lines);
+                break;
+            }
+        }
+    }
+}
+
+size_t TransitNodeRouting::memoryUsage() const
+{
+    size_t bytes = (transitOf.size() + transitNodes.size() + via.size()) * sizeof(uint32_t) + table.size() * sizeof(double);
+    for (int side = 0; side < 2; side++) {
+        bytes += (accessOffsets[side].size() + accessNodes[side].size()) * sizeof(uint32_t)
+            + accessDistances[side].size() * sizeof(double) + boxes[side].size() * sizeof(Box);
+    }
+    return bytes;
+}
+
+TransitNodeQuery::TransitNodeQuery(const TransitNodeRouting& routing, const ContractionHierarchy& hierarchy, bool withPath)
+    : routing(routing), hierarchy(hierarchy), local(hierarchy), withPath(withPath)
+{
+    if (withPath) {
+        dist.assign(hierarchy.nodeCount(), numeric_limits<double>::infinity());
+        parent.assign(hierarchy.nodeCount(), UINT32_MAX);
+    }
+}
+
+// -----------------------------------------------------------
+// Repeats the upward search of v (not continued past transit
+// nodes) until the access node is settled, then unpacks the
+// hierarchy arcs between them in path order
+// -----------------------------------------------------------
+void TransitNodeQuery::appendAccessPath(int side, uint32_t v, uint32_t access, vector<uint32_t>& nodes, vector<uint32_t>& lines)
+{
+    const double unreached = numeric_limits<double>::infinity();
+    for (uint32_t u : touched) {
+        dist[u] = unreached;
+        parent[u] = UINT32_MAX;
+    }
+    touched.clear();
+
+    const vector<uint32_t>& offsets = side == 0 ? hierarchy.upOffsets : hierarchy.downOffsets;
+    const vector<ContractionHierarchy::Arc>& arcs = side == 0 ? hierarchy.upArcs : hierarchy.downArcs;
+    uint32_t accessNode = routing.transitNode(access);
+
+    typedef pair<double, uint32_t> Entry;
+    priority_queue<Entry, vector<Entry>, greater<Entry>> pq;
+
+    dist[v] = 0.0;
+    touched.push_back(v);
+    pq.push({ 0.0, v });
+    while (!pq.empty()) {
+        auto [d, u] = pq.top();
+        pq.pop();
+        if (d > dist[u]) continue;  // Skip outdated values
+        if (u == accessNode) break;
+        if (routing.transitIndex(u) != UINT32_MAX) continue;
+
+        for (uint32_t i = offsets[u]; i < offsets[u + 1]; i++) {
+            uint32_t w = arcs[i].node;
+            double alt = d + arcs[i].weight;
+            if (alt < dist[w]) {
+                if (dist[w] == unreached) touched.push_back(w);
+                dist[w] = alt;
+                parent[w] = i;
+                pq.push({ alt, w });
+            }
+        }
+    }
+
+    if (side == 0) {
+        // Upward arcs v -> access node: walk back via their tails
+        vector<pair<uint32_t, uint32_t>> upward;   // (tail, arc index)
+        for (uint32_t u = accessNode; u != v;) {
+            uint32_t arc = parent[u];
+            uint32_t tail = static_cast<uint32_t>(upper_bound(hierarchy.upOffsets.begin(), hierarchy.upOffsets.end(), arc)
+                - hierarchy.upOffsets.begin() - 1);
+            upward.push_back({ tail, arc });
+            u = tail;
+        }
+        for (auto it = upward.rbegin(); it != upward.rend(); ++it) {
+            const ContractionHierarchy::Arc& arc = hierarchy.upArcs[it->second];
+            hierarchy.unpack(it->first, arc.node, arc.middle, arc.lineId, nodes, lines);
+        }
+        return;
+    }
+
+    // Downward arcs access node -> v: stored at their heads, already in path order
+    for (uint32_t u = accessNode; u != v;) {
+        uint32_t arc = parent[u];
+        uint32_t head = static_cast<uint32_t>(upper_bound(hierarchy.downOffsets.begin(), hierarchy.downOffsets.end(), arc)
+            - hierarchy.downOffsets.begin() - 1);
+        hierarchy.unpack(u, head, hierarchy.downArcs[arc].middle, hierarchy.downArcs[arc].lineId, nodes, lines);
+        u = head;
+    }
+}
+
+PathResult<uint32_t, double> TransitNodeQuery::run(uint32_t source, uint32_t target)
+{
+    if (!routing.isLocal(source, target)) {
+        PathResult<uint32_t, double> result;
+        uint32_t a = 0, b = 0;
+        result.distance = routing.distance(source, target, &settled, &a, &b);
+        result.found = result.distance != numeric_limits<double>::infinity();
+        if (!result.found || !withPath) return result;
+
+        // source -> a, a -> b through the table, b -> target
+        result.nodes.push_back(source);
+        appendAccessPath(0, source, a, result.nodes, result.lines);
+        routing.appendTablePath(hierarchy, a, b, result.nodes, result.lines);
+        appendAccessPath(1, target, b, result.nodes, result.lines);
+        return result;
+    }
+
+    localRuns++;
+    PathResult<uint32_t, double> result = local.run(source, target);
+    settled = local.settledCount();
+    return result;
+}
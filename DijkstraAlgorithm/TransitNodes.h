@@ -0,0 +1,147 @@
+#pragma once
+
+#ifndef TRANSITNODES_H
+#define TRANSITNODES_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "ShortestPathQuery.h"
+#include "ContractionHierarchy.h"
+
+using namespace std;
+
+// Transit nodes (top of the contraction order) per square root of the
+// node count by default, as long as their table (distance and
+// predecessor per pair) fits TNR_TABLE_BUDGET bytes; larger graphs
+// get fewer transit nodes and more local queries
+#define TNR_TRANSIT_FACTOR 10
+#define TNR_TABLE_BUDGET (16 * 1024 * 1024)
+
+// ------------------------------------------------------------
+// Transit Node Routing on top of a contraction hierarchy.
+// The most important nodes of the contraction order are the transit
+// nodes; long shortest paths almost always pass through one.
+//  - table: distances between all transit nodes (Dijkstra on the
+//    transit nodes alone, which hold every up-down path between them)
+//  - access nodes: the transit nodes an upward search from v reaches
+//    without passing another transit node, minus those reached
+//    faster through another access node; per side (0 = from v,
+//    1 = to v)
+//  - locality filter: the bounding box of the nodes each upward
+//    search settles below the transit level. The highest node of
+//    the CH path from s to t is settled by both searches, so if the
+//    boxes of s and t are disjoint it is a transit node, and
+//      d(s, t) = min d(s, a) + table(a, b) + d(b, t)
+//    over the access nodes a of s and b of t: a few table lookups.
+//    Other queries are local and run the CH query.
+//  - paths: the table keeps the transit node before b on the path
+//    from a, so a -> b unpacks through the hierarchy arcs between
+//    transit nodes; s -> a and b -> t repeat the upward searches.
+// Node ids are those of the hierarchy; coordinates are given per
+// node id in that numbering (as for EuclideanPotential).
+// ------------------------------------------------------------
+class TransitNodeRouting
+{
+public:
+    struct Box {
+        double minX, minY, maxX, maxY;
+    };
+
+private:
+    vector<uint32_t> transitOf;     // Node id -> transit index (UINT32_MAX if none)
+    vector<uint32_t> transitNodes;  // Transit index -> node id
+    vector<double> table;           // Transit index a * count + b -> d(a, b)
+    vector<uint32_t> via;           // Transit index a * count + b -> transit index before b on that path
+
+    vector<uint32_t> accessOffsets[2];  // Access nodes of v = [offsets[v], offsets[v + 1])
+    vector<uint32_t> accessNodes[2];    // Transit index
+    vector<double> accessDistances[2];
+    vector<Box> boxes[2];               // Search space below the transit level (empty for transit nodes)
+    uint64_t fingerprint = 0;
+
+    // Distances between all transit nodes
+    void buildTable(const ContractionHierarchy& hierarchy);
+
+    // Access nodes and search space boxes of one side
+    void buildAccess(const ContractionHierarchy& hierarchy, int side, const vector<double>& x, const vector<double>& y,
+        unsigned threads);
+
+public:
+    TransitNodeRouting() {}
+
+    // Selects the 'transitCount' highest nodes of the hierarchy (0 = TNR_TRANSIT_FACTOR * sqrt(nodes),
+    // at most what fits TNR_TABLE_BUDGET)
+    // and computes table, access nodes and boxes using all cores (threads = 0) or the given number of threads
+    void build(const ContractionHierarchy& hierarchy, const vector<double>& x, const vector<double>& y,
+        size_t transitCount = 0, unsigned threads = 0);
+
+    bool empty() const { return transitOf.empty(); }
+    size_t nodeCount() const { return transitOf.size(); }
+    size_t transitCount() const { return transitNodes.size(); }
+    uint64_t getFingerprint() const { return fingerprint; }
+    uint32_t transitIndex(uint32_t v) const { return transitOf[v]; }
+    uint32_t transitNode(uint32_t index) const { return transitNodes[index]; }
+
+    // Access nodes per node and side
+    double averageAccessCount() const;
+
+    // True if the tables may miss the shortest path from s to t
+    bool isLocal(uint32_t s, uint32_t t) const;
+
+    // Table distance from s to t (infinity if none), exact for queries that are not local;
+    // 'lookups' receives the access node pairs combined, 'sourceAccess' and 'targetAccess'
+    // the transit indexes of the best pair
+    double distance(uint32_t s, uint32_t t, size_t* lookups = nullptr, uint32_t* sourceAccess = nullptr,
+        uint32_t* targetAccess = nullptr) const;
+
+    // Appends the original lines of the table path between transit indexes a and b
+    void appendTablePath(const ContractionHierarchy& hierarchy, uint32_t a, uint32_t b,
+        vector<uint32_t>& nodes, vector<uint32_t>& lines) const;
+
+    // Bytes used by table, access nodes and boxes
+    size_t memoryUsage() const;
+};
+
+// ------------------------------------------------------------
+// Query interface over TransitNodeRouting (as the other query
+// classes): local queries run the CH query, the others read the
+// tables. Their paths join the upward search paths to the best
+// access nodes and the table path between them, all unpacked by
+// the hierarchy.
+// ------------------------------------------------------------
+class TransitNodeQuery
+{
+public:
+    typedef uint32_t NodeId;
+    typedef double Weight;
+
+private:
+    const TransitNodeRouting& routing;
+    const ContractionHierarchy& hierarchy;
+    CHQuery local;
+    bool withPath;
+    size_t settled = 0;
+    size_t localRuns = 0;
+
+    // Upward search from v to one of its access nodes (path queries only)
+    vector<double> dist;
+    vector<uint32_t> parent;        // Arc index the node was reached through
+    vector<uint32_t> touched;
+
+    // Appends the path v -> access node (side 0) or access node -> v (side 1)
+    void appendAccessPath(int side, uint32_t v, uint32_t access, vector<uint32_t>& nodes, vector<uint32_t>& lines);
+
+public:
+    TransitNodeQuery(const TransitNodeRouting& routing, const ContractionHierarchy& hierarchy, bool withPath = true);
+
+    PathResult<uint32_t, double> run(uint32_t source, uint32_t target);
+
+    // Nodes settled by the CH query or access node pairs read by the last run
+    size_t settledCount() const { return settled; }
+
+    // Runs so far that needed the CH query (local queries)
+    size_t localCount() const { return localRuns; }
+};
+
+#endif
@@ -9,7 +9,7 @@ bool isFirstCharAlpha(const std::string& name) {
 }
 
 // Validates a new point before adding it to the existing points
-bool validateNewPoint(const Point& newPoint, const std::vector<Point>& existingPoints) {
+bool validateNewPoint(const Point& newPoint, const GraphStorage& graph) {
     // First character of point name must be a letter
     if (!isFirstCharAlpha(newPoint.getName())) {
         cout << "Line Error: First character of Point name must be letter" << endl;
@@ -17,11 +17,10 @@ bool validateNewPoint(const Point& newPoint, const std::vector<Point>& existingP
     }
 
     // Check for duplicate points (by coordinates or name)
-    for (const auto& existingP : existingPoints) {
-        if (existingP == newPoint) {
-            cout << "Line Error: Point Exist" << endl;
-            return false;
-        }
+    if (graph.findPoint(newPoint.getName()) != INVALID_POINT_ID ||
+        graph.hasPointAt(newPoint.getX(), newPoint.getY())) {
+        cout << "Line Error: Point Exist" << endl;
+        return false;
     }
 
     return true; // Point is valid
@@ -29,7 +28,7 @@ bool validateNewPoint(const Point& newPoint, const std::vector<Point>& existingP
 
 // Validates a new line before adding it to the existing lines
 bool validateNewLine(const string& startName, const std::string& endName, double weight,
-    const std::vector<Line>& existingLines, const std::vector<Point>& points)
+    const GraphStorage& graph, bool directed)
 {
     // Start and end points cannot be the same
     if (startName == endName) {
@@ -55,13 +54,12 @@ bool validateNewLine(const string& startName, const std::string& endName, double
         return false;
     }
 
-    // Check if line already exists (both directions considered)
-    for (const auto& line : existingLines) {
-        if ((line.getStart().getName() == startName && line.getEnd().getName() == endName) ||
-            (line.getStart().getName() == endName && line.getEnd().getName() == startName)) {
-            cout << "Line Error: Line Exist" << endl;
-            return false;
-        }
+    // Check if line already exists (a one-way line may run against another one)
+    uint32_t startId = graph.findPoint(startName);
+    uint32_t endId = graph.findPoint(endName);
+    if (startId != INVALID_POINT_ID && endId != INVALID_POINT_ID && graph.conflictsWithLine(startId, endId, directed)) {
+        cout << "Line Error: Line Exist" << endl;
+        return false;
     }
 
     return true; // Line is valid
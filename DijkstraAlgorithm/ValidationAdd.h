@@ -7,10 +7,12 @@
 #include <vector>
 #include "Point.h"
 #include "Line.h"
+#include "GraphStorage.h"
 
 bool isFirstCharAlpha(const std::string& name);
-bool validateNewPoint(const Point& newPoint, const std::vector<Point>& existingPoints);
-bool validateNewLine(const string& startName, const std::string& endName, double weight, const std::vector<Line>& existingLines, const std::vector<Point>& points);
+bool validateNewPoint(const Point& newPoint, const GraphStorage& graph);
+bool validateNewLine(const string& startName, const std::string& endName, double weight, const GraphStorage& graph,
+    bool directed = false);
 
 #endif
 
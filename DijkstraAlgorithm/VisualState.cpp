@@ -0,0 +1,72 @@
+#include "VisualState.h"
+
+void VisualState::reset(size_t nodeCount, size_t edgeCount)
+{
+    nodes.assign(nodeCount, NodeState());
+    edges.assign(edgeCount, EdgeState());
+}
+
+void VisualState::setNodeColor(uint32_t id, const sf::Color& color)
+{
+    if (id >= nodes.size()) nodes.resize(id + 1);
+    nodes[id].color = color;
+    nodes[id].active = true;
+}
+
+void VisualState::clearNodeColor(uint32_t id)
+{
+    if (id < nodes.size()) nodes[id].active = false;
+}
+
+void VisualState::setEdge(uint32_t id, const sf::Color& color, double boldness)
+{
+    if (id >= edges.size()) edges.resize(id + 1);
+    edges[id].color = color;
+    edges[id].boldness = boldness;
+    edges[id].active = true;
+}
+
+void VisualState::clearEdge(uint32_t id)
+{
+    if (id < edges.size()) edges[id].active = false;
+}
+
+void VisualState::clearEdges()
+{
+    for (auto& e : edges) e.active = false;
+}
+
+void VisualState::setEdgeInPath(uint32_t id, bool inPath)
+{
+    if (id >= edges.size()) edges.resize(id + 1);
+    edges[id].inPath = inPath;
+}
+
+sf::Color VisualState::nodeColor(uint32_t id, const sf::Color& baseColor) const
+{
+    if (id < nodes.size() && nodes[id].active) return nodes[id].color;
+    return baseColor;
+}
+
+sf::Color VisualState::edgeColor(uint32_t id) const
+{
+    if (id < edges.size()) {
+        if (edges[id].active) return edges[id].color;
+        if (edges[id].inPath) return IS_PATH_COLOR_LINE;
+    }
+    return BASE_COLOR_LINE;
+}
+
+double VisualState::edgeBoldness(uint32_t id) const
+{
+    if (id < edges.size()) {
+        if (edges[id].active) return edges[id].boldness;
+        if (edges[id].inPath) return IS_PATH_BOLDNESS_LINE;
+    }
+    return BASE_BOLDNESS_LINE;
+}
+
+bool VisualState::edgeInPath(uint32_t id) const
+{
+    return id < edges.size() && edges[id].inPath;
+}
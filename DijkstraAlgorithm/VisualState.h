@@ -0,0 +1,70 @@
+#pragma once
+
+#ifndef VISUALSTATE_H
+#define VISUALSTATE_H
+
+#include <vector>
+#include <mutex>
+#include <cstdint>
+#include <SFML/Graphics.hpp>
+#include "Point.h"
+#include "Line.h"
+
+using namespace std;
+
+// ------------------------------------------------------------
+// Render-state overlay for algorithm visualization.
+// Holds per-node colors and per-edge color/boldness/inPath arrays
+// indexed by point and line ids. The algorithm publishes into the
+// overlay while Points and Lines stay untouched, and the renderer
+// draws overlay state on top of the model's base look.
+//
+// The overlay has its own mutex; callers lock it (getMutex) around
+// every batch of reads or writes. Lock order: dataMutex first.
+// ------------------------------------------------------------
+class VisualState
+{
+private:
+    struct NodeState {
+        sf::Color color;
+        bool active = false; // Overrides the point's own color
+    };
+
+    struct EdgeState {
+        sf::Color color = BASE_COLOR_LINE;
+        double boldness = BASE_BOLDNESS_LINE;
+        bool active = false; // Overrides the base line look
+        bool inPath = false; // Part of the final shortest path
+    };
+
+    mutable mutex overlayMutex;
+    vector<NodeState> nodes;
+    vector<EdgeState> edges;
+
+public:
+    mutex& getMutex() const { return overlayMutex; }
+
+    // Drops all overlay state and sizes the arrays for the given id ranges
+    void reset(size_t nodeCount, size_t edgeCount);
+
+    // Drops all overlay state (back to the model's own look)
+    void clear() { reset(0, 0); }
+
+    // Node state
+    void setNodeColor(uint32_t id, const sf::Color& color);
+    void clearNodeColor(uint32_t id);
+
+    // Edge state
+    void setEdge(uint32_t id, const sf::Color& color, double boldness);
+    void clearEdge(uint32_t id);
+    void clearEdges();
+    void setEdgeInPath(uint32_t id, bool inPath);
+
+    // Renderer queries (fall back to the base look for ids without overlay state)
+    sf::Color nodeColor(uint32_t id, const sf::Color& baseColor) const;
+    sf::Color edgeColor(uint32_t id) const;
+    double edgeBoldness(uint32_t id) const;
+    bool edgeInPath(uint32_t id) const;
+};
+
+#endif
@@ -0,0 +1,65 @@
+#include "WeightProfiles.h"
+
+size_t WeightProfiles::find(string_view name) const
+{
+    for (size_t p = 0; p < names.size(); p++) {
+        if (names[p] == name) return p;
+    }
+    return INVALID_PROFILE;
+}
+
+void WeightProfiles::setNames(vector<string> profileNames)
+{
+    if (profileNames.empty()) profileNames.push_back(DEFAULT_PROFILE_NAME);
+    names = move(profileNames);
+    columns.assign(names.size() - 1, ChunkedColumn<double>());
+}
+
+void WeightProfiles::set(size_t profile, uint32_t lineId, double weight)
+{
+    ChunkedColumn<double>& column = columns[profile - 1];
+    column.resize(static_cast<size_t>(lineId) + 1, 0.0);
+    column[lineId] = weight;
+}
+
+void WeightProfiles::addLine(uint32_t lineId, double weight)
+{
+    for (size_t p = 1; p < names.size(); p++) set(p, lineId, weight);
+}
+
+void WeightProfiles::clearLines()
+{
+    for (ChunkedColumn<double>& column : columns) column.clear();
+}
+
+void WeightProfiles::reserve(size_t lineCount)
+{
+    for (ChunkedColumn<double>& column : columns) column.reserve(lineCount);
+}
+
+// FNV-1a parameters of the weight fingerprint
+#define FINGERPRINT_BASIS 14695981039346656037ULL
+#define FINGERPRINT_PRIME 1099511628211ULL
+
+static void hashBytes(uint64_t& hash, const void* data, size_t size)
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= FINGERPRINT_PRIME;
+    }
+}
+
+uint64_t weightFingerprint(const LineStore& lines, const WeightProfiles& profiles, size_t profile)
+{
+    uint64_t hash = FINGERPRINT_BASIS;
+    for (auto it = lines.begin(); it != lines.end(); ++it) {
+        uint32_t ids[3] = { it.slot(), it->getStartId(), it->getEndId() };
+        double weight = profiles.get(lines, profile, it.slot());
+        bool directed = it->isDirected();
+        hashBytes(hash, ids, sizeof(ids));
+        hashBytes(hash, &weight, sizeof(weight));
+        hashBytes(hash, &directed, sizeof(directed));
+    }
+    return hash;
+}
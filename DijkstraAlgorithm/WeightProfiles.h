@@ -0,0 +1,77 @@
+#pragma once
+
+#ifndef WEIGHTPROFILES_H
+#define WEIGHTPROFILES_H
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include "Line.h"
+#include "ChunkedColumn.h"
+
+using namespace std;
+
+// Name of the only profile when a lines file declares none
+#define DEFAULT_PROFILE_NAME "weight"
+
+// Index returned when no profile matches a name
+#define INVALID_PROFILE SIZE_MAX
+
+// ------------------------------------------------------------
+// Named weight columns (metric profiles) of the lines, e.g.
+// distance, time and cost of the same road.
+// Profile 0 is the weight stored in every Line; each further
+// profile is one column indexed by line id, so the topology and
+// the points are held once however many metrics are loaded, and
+// a query touches only the column it runs on.
+// Lines added without values for the extra profiles take the
+// primary weight in every column.
+// Columns are chunked, so versions share them and a weight edit
+// copies one chunk.
+// ------------------------------------------------------------
+class WeightProfiles
+{
+private:
+    vector<string> names;                   // names[p] of every profile, names[0] = Line weight
+    vector<ChunkedColumn<double>> columns;  // columns[p - 1][lineId] for profiles p >= 1
+
+public:
+    WeightProfiles() : names(1, DEFAULT_PROFILE_NAME) {}
+
+    size_t count() const { return names.size(); }
+    const string& getName(size_t profile) const { return names[profile]; }
+
+    // Index of the profile with the given name or INVALID_PROFILE
+    size_t find(string_view name) const;
+
+    // Replaces the profiles by the given names (at least one), dropping all columns
+    void setNames(vector<string> profileNames);
+
+    // Weight of a line in a profile
+    double get(const LineStore& lines, size_t profile, uint32_t lineId) const {
+        return profile == 0 ? lines[lineId].getWeight() : columns[profile - 1][lineId];
+    }
+
+    // Sets the weight of a line in an extra profile (profile >= 1)
+    void set(size_t profile, uint32_t lineId, double weight);
+
+    // Gives a new line the primary weight in every extra profile
+    void addLine(uint32_t lineId, double weight);
+
+    // Keeps the names, drops the weights of all lines
+    void clearLines();
+
+    // Pre-sizes the columns for lineCount line ids
+    void reserve(size_t lineCount);
+};
+
+// ------------------------------------------------------------
+// Hash of everything query indexes (landmarks, hierarchies)
+// depend on: the lines (ids, endpoints, direction) and their
+// weights in one profile. A prepared index is only used while
+// the fingerprint of the graph matches the one it was built for.
+// ------------------------------------------------------------
+uint64_t weightFingerprint(const LineStore& lines, const WeightProfiles& profiles, size_t profile);
+
+#endif
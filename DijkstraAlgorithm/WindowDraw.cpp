@@ -21,6 +21,10 @@ float LABEL_OFFSET_Y = -7.0f;
 const unsigned int FONT_SIZE = 20;
 const unsigned int WEIGHT_FONT_SIZE = 15;
 
+// Arrowhead of one-way lines, in multiples of the line thickness
+const float ARROW_LENGTH_FACTOR = 4.0f;
+const float ARROW_MIN_LENGTH = 8.0f;
+
 // Toggles for rendering optional elements
 bool LABEL_SHOW = true;
 bool WEIGHT_SHOW = true;
@@ -42,21 +46,24 @@ struct ScaleInfo {
 // Determines the bounding box of the data and calculates scale factors
 // so that the graph fills the screen while maintaining a margin.
 //------------------------------------------------------------------------
-ScaleInfo getScaleAndBounds(const std::vector<Point>& points, double windowSizeX, double windowSizeY) {
+ScaleInfo getScaleAndBounds(const PointStore& points, double windowSizeX, double windowSizeY) {
     // Edge case: No points to draw
     if (points.empty()) {
         return { 1.0, 1.0, 0.0, 0.0, 0.0, 0.0, 1.0 };
     }
 
-    double minX = points[0].getX(), maxX = points[0].getX();
-    double minY = points[0].getY(), maxY = points[0].getY();
-
-    // Iterate through all points to find the bounding box (min/max coordinates)
-    for (const auto& p : points) {
-        if (p.getX() < minX) minX = p.getX();
-        if (p.getX() > maxX) maxX = p.getX();
-        if (p.getY() < minY) minY = p.getY();
-        if (p.getY() > maxY) maxY = p.getY();
+    // Stream through the geometry columns to find the bounding box (min/max coordinates)
+    uint32_t first = points.begin().slot();
+    double minX = points.getX(first), maxX = minX;
+    double minY = points.getY(first), maxY = minY;
+
+    for (uint32_t i = first + 1; i < points.capacity(); i++) {
+        if (!points.isOccupied(i)) continue;
+        double x = points.getX(i), y = points.getY(i);
+        if (x < minX) minX = x;
+        if (x > maxX) maxX = x;
+        if (y < minY) minY = y;
+        if (y > maxY) maxY = y;
     }
 
     double rangeX = maxX - minX;
@@ -105,10 +112,10 @@ ScaleInfo getScaleAndBounds(const std::vector<Point>& points, double windowSizeX
 // Mathematical coordinate systems usually have Y increasing upwards.
 // We must invert the Y-axis here.
 //------------------------------------------------------------------------
-sf::Vector2f transformPoint(const Point& p, const ScaleInfo& info, double scaleX, double scaleY) {
+sf::Vector2f transformPoint(double px, double py, const ScaleInfo& info, double scaleX, double scaleY) {
     // Center the point relative to the data's center
-    double centeredX = p.getX() - info.centerX;
-    double centeredY = p.getY() - info.centerY;
+    double centeredX = px - info.centerX;
+    double centeredY = py - info.centerY;
 
     // Scale the coordinates to pixels
     // We start drawing from the center of the window
@@ -121,7 +128,7 @@ sf::Vector2f transformPoint(const Point& p, const ScaleInfo& info, double scaleX
 }
 
 // Renders the vertices (nodes) of the graph
-void drawPoints(const std::vector<Point>& points, sf::RenderWindow& window) {
+void drawPoints(const PointStore& points, const VisualState& visual, sf::RenderWindow& window) {
     if (points.empty()) return;
 
     double width = static_cast<double>(window.getSize().x);
@@ -145,11 +152,11 @@ void drawPoints(const std::vector<Point>& points, sf::RenderWindow& window) {
         float outlineOffset = std::max(std::min(calculatedOutlineOffset, static_cast<float>(p.getOutlineSize())), 1.0f);
         shape.setOutlineThickness(outlineOffset);
 
-        shape.setFillColor(p.getColor());
+        shape.setFillColor(visual.nodeColor(p.getId(), p.getColor()));
         shape.setOutlineColor(p.getOutlineColor());
 
         // Get relative position and shift to screen center
-        sf::Vector2f pos = transformPoint(p, scaleData, sharedScaleX, sharedScaleY);
+        sf::Vector2f pos = transformPoint(p.getX(), p.getY(), scaleData, sharedScaleX, sharedScaleY);
 
         // Offset by radius so the point is centered exactly on the coordinate
         shape.setPosition(sf::Vector2f(pos.x - shape.getRadius(), pos.y - shape.getRadius()));
@@ -159,7 +166,7 @@ void drawPoints(const std::vector<Point>& points, sf::RenderWindow& window) {
 }
 
 // Renders the edges (connections) between nodes
-void drawLines(const std::vector<Line>& lines, const std::vector<Point>& points, sf::RenderWindow& window) {
+void drawLines(const LineStore& lines, const PointStore& points, const VisualState& visual, sf::RenderWindow& window) {
     if (points.empty() || lines.empty()) return;
 
     double width = static_cast<double>(window.getSize().x);
@@ -170,10 +177,15 @@ void drawLines(const std::vector<Line>& lines, const std::vector<Point>& points,
     double sharedScaleY = scaleData.scaleY;
     double visualScale = scaleData.visualScale;
 
-    for (const auto& line : lines) {
+    for (auto it = lines.begin(); it != lines.end(); ++it) {
+        const Line& line = *it;
+
+        // Current look of the line (base look unless the algorithm overlay changed it)
+        double lineBoldness = visual.edgeBoldness(it.slot());
+
         // Calculate start and end positions relative to center
-        sf::Vector2f startPos = transformPoint(line.getStart(), scaleData, sharedScaleX, sharedScaleY);
-        sf::Vector2f endPos = transformPoint(line.getEnd(), scaleData, sharedScaleX, sharedScaleY);
+        sf::Vector2f startPos = transformPoint(points.getX(line.getStartId()), points.getY(line.getStartId()), scaleData, sharedScaleX, sharedScaleY);
+        sf::Vector2f endPos = transformPoint(points.getX(line.getEndId()), points.getY(line.getEndId()), scaleData, sharedScaleX, sharedScaleY);
 
 
         // Calculate the vector from Start to End
@@ -182,12 +194,12 @@ void drawLines(const std::vector<Line>& lines, const std::vector<Point>& points,
         float lineLength = std::sqrt(direction.x * direction.x + direction.y * direction.y);
 
         // Determine line thickness (boldness)
-        float calculatedBoldness = static_cast<float>(line.getBoldness() * visualScale);
-        float boldness = std::max(std::min(calculatedBoldness, static_cast<float>(line.getBoldness())), 1.0f);
+        float calculatedBoldness = static_cast<float>(lineBoldness * visualScale);
+        float boldness = std::max(std::min(calculatedBoldness, static_cast<float>(lineBoldness)), 1.0f);
 
         // We use a RectangleShape instead of SFML lines because Rectangles support thickness/rotation better
         sf::RectangleShape rect(sf::Vector2f(lineLength, boldness));
-        rect.setFillColor(line.getColor());
+        rect.setFillColor(visual.edgeColor(it.slot()));
         rect.setPosition(startPos);
 
         // Compute rotation angle using atan2 (arc tangent)
@@ -197,14 +209,30 @@ void drawLines(const std::vector<Line>& lines, const std::vector<Point>& points,
 
         // Set the origin (pivot point) to the vertical center of the line's start
         // This ensures the line is drawn centered on the mathematical coordinates
-        rect.setOrigin(sf::Vector2f(0.0f, line.getBoldness() / 2.0f));
+        rect.setOrigin(sf::Vector2f(0.0f, lineBoldness / 2.0f));
 
         window.draw(rect);
+
+        // One-way lines get an arrowhead halfway along, pointing to the end point
+        if (line.isDirected() && lineLength > 0.0f) {
+            float arrowLength = std::max(boldness * ARROW_LENGTH_FACTOR, ARROW_MIN_LENGTH);
+            sf::Vector2f unit = direction / lineLength;
+            sf::Vector2f normal(-unit.y, unit.x);
+            sf::Vector2f tip = startPos + direction * 0.5f + unit * (arrowLength / 2.0f);
+            sf::Vector2f back = tip - unit * arrowLength;
+
+            sf::ConvexShape arrow(3);
+            arrow.setPoint(0, tip);
+            arrow.setPoint(1, back + normal * (arrowLength / 2.0f));
+            arrow.setPoint(2, back - normal * (arrowLength / 2.0f));
+            arrow.setFillColor(visual.edgeColor(it.slot()));
+            window.draw(arrow);
+        }
     }
 }
 
 // Renders text names next to the points
-void drawLabels(const std::vector<Point>& points, sf::RenderWindow& window) {
+void drawLabels(const PointStore& points, sf::RenderWindow& window) {
     if (points.empty()) return;
 
     // Load font only once (Lazy Loading)
@@ -227,13 +255,13 @@ void drawLabels(const std::vector<Point>& points, sf::RenderWindow& window) {
     for (const auto& p : points) {
         if (p.getName().empty()) continue;
 
-        sf::Vector2f pos = transformPoint(p, scaleData, sharedScaleX, sharedScaleY);
+        sf::Vector2f pos = transformPoint(p.getX(), p.getY(), scaleData, sharedScaleX, sharedScaleY);
 
         sf::Text labelText(globalFont);
 
         // Scale font size dynamically but clamp it so it doesn't get too small or too huge
         float size = std::max(std::min(static_cast<float>(FONT_SIZE * visualScale), static_cast<float>(FONT_SIZE)), FONT_SIZE / 3.0f);
-        labelText.setString(p.getName());
+        labelText.setString(string(p.getName()));
         labelText.setCharacterSize(size);
         labelText.setFillColor(sf::Color::Black);
 
@@ -263,7 +291,7 @@ std::string formatWeightString(double weight) {
 }
 
 // Renders numerical weights at the center of edges
-void drawEdgeWeights(const std::vector<Line>& lines, const std::vector<Point>& points, sf::RenderWindow& window) {
+void drawEdgeWeights(const LineStore& lines, const PointStore& points, sf::RenderWindow& window) {
     if (points.empty() || lines.empty()) return;
 
     if (!fontLoaded) {
@@ -284,8 +312,8 @@ void drawEdgeWeights(const std::vector<Line>& lines, const std::vector<Point>& p
 
     for (const auto& line : lines) {
         // Calculate start and end positions
-        sf::Vector2f startPos = transformPoint(line.getStart(), scaleData, sharedScaleX, sharedScaleY);
-        sf::Vector2f endPos = transformPoint(line.getEnd(), scaleData, sharedScaleX, sharedScaleY);
+        sf::Vector2f startPos = transformPoint(points.getX(line.getStartId()), points.getY(line.getStartId()), scaleData, sharedScaleX, sharedScaleY);
+        sf::Vector2f endPos = transformPoint(points.getX(line.getEndId()), points.getY(line.getEndId()), scaleData, sharedScaleX, sharedScaleY);
 
         // Calculate the midpoint of the line to place the text
         sf::Vector2f centerPos;